@@ -1,21 +1,36 @@
 #include <iostream>
+#include <cstring>
 #include "utils/ai/Agent.h"
 #include "utils/board/BoardManager.h"
 
-int main() {
+int main(int argc, char **argv) {
+    BoardManager bm = BoardManager();
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            bm.setSeed(strtoull(argv[++i], nullptr, 10));
+        } else if (strncmp(argv[i], "--seed=", 7) == 0) {
+            bm.setSeed(strtoull(argv[i] + 7, nullptr, 10));
+        } else {
+            std::cout << "Usage: " << argv[0] << " [--seed <n>]\n";
+            exit(1);
+        }
+    }
+
     int opt = 0;
     std::cout << "[1] Load AI file to play against user\n";
     std::cout << "[2] Load AI file to play against another AI\n";
     std::cout << "[3] Benchmark an AI file\n";
     std::cout << "[4] Train new AI\n";
+    std::cout << "[5] Train new AI from an episode log\n";
+    std::cout << "[6] Analyze and compact an AI file\n";
+    std::cout << "[7] Train new AI with a population of hyperparameters\n";
     std::cout << "Choose an option: ";
     std::cin >> opt;
 
-    BoardManager bm = BoardManager();
-
     switch (opt) {
         case 1: {
-            char debugMode;
+            char debugMode, ponder;
             std::string fileName;
 
             std::cout << "File name: ";
@@ -23,8 +38,10 @@ int main() {
             std::getline(std::cin, fileName);
             std::cout << "Show debug info? (y/n): ";
             std::cin >> debugMode;
+            std::cout << "Think during your turn? (y/n): ";
+            std::cin >> ponder;
 
-            bm.AiVsHuman(fileName, debugMode == 'y');
+            bm.AiVsHuman(fileName, debugMode == 'y', ponder == 'y');
             break;
         }
 
@@ -54,7 +71,9 @@ int main() {
         }
 
         case 4: {
-            int boardSize, winStr, trainIterations;
+            int boardSize, winStr, trainIterations, parallelGames, liveEvery, sweepBackups;
+            float lambda;
+            char earlyStop, shared;
 
             std::cout << "Board size: ";
             std::cin >> boardSize;
@@ -62,8 +81,71 @@ int main() {
             std::cin >> winStr;
             std::cout << "Training iterations: ";
             std::cin >> trainIterations;
+            std::cout << "Stop early on convergence? (y/n): ";
+            std::cin >> earlyStop;
+            std::cout << "Games played in lockstep (1 for one at a time): ";
+            std::cin >> parallelGames;
+            std::cout << "Single file for both X and O? (y/n): ";
+            std::cin >> shared;
+            std::cout << "Evaluate in the background every N games (0 for none): ";
+            std::cin >> liveEvery;
+            std::cout << "Prioritized sweeping updates per game (0 for none): ";
+            std::cin >> sweepBackups;
+            std::cout << "TD(lambda) trace decay, 0 to 1 (-1 for the classic update): ";
+            std::cin >> lambda;
+
+            bm.train(boardSize, winStr, trainIterations, earlyStop == 'y', parallelGames, shared == 'y', liveEvery,
+                     sweepBackups, lambda);
+            break;
+        }
+
+        case 5: {
+            std::string logFileName;
+            float learningRate, decayGamma, lambda;
+            char shared;
+
+            std::cout << "Episode log file name: ";
+            fflush(stdin);
+            std::getline(std::cin, logFileName);
+            std::cout << "Learning rate: ";
+            std::cin >> learningRate;
+            std::cout << "Decay gamma: ";
+            std::cin >> decayGamma;
+            std::cout << "Single file for both X and O? (y/n): ";
+            std::cin >> shared;
+            std::cout << "TD(lambda) trace decay, 0 to 1 (-1 for the classic update): ";
+            std::cin >> lambda;
+
+            bm.replayTrain(logFileName, learningRate, decayGamma, shared == 'y', lambda);
+            break;
+        }
+
+        case 6: {
+            std::string aiFileName;
+
+            std::cout << "AI file name: ";
+            fflush(stdin);
+            std::getline(std::cin, aiFileName);
+
+            bm.analyzeAi(aiFileName);
+            break;
+        }
+
+        case 7: {
+            int boardSize, winStr, populationSize, rounds, gamesPerRound;
+
+            std::cout << "Board size: ";
+            std::cin >> boardSize;
+            std::cout << "Streak to win: ";
+            std::cin >> winStr;
+            std::cout << "Population size: ";
+            std::cin >> populationSize;
+            std::cout << "Rounds: ";
+            std::cin >> rounds;
+            std::cout << "Games per round: ";
+            std::cin >> gamesPerRound;
 
-            bm.train(boardSize, winStr, trainIterations);
+            bm.populationTrain(boardSize, winStr, populationSize, rounds, gamesPerRound);
             break;
         }
 
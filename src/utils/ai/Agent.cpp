@@ -1,5 +1,8 @@
 #include <iostream>
+#include <cmath>
 #include "Agent.h"
+#include "ValuePrior.h"
+#include "Sweeper.h"
 
 /**
  * An autonomous agent capable of training and playing
@@ -16,10 +19,19 @@ Agent::Agent(Board *board, char tag, float expRate, float decayGamma, float lear
     this->expRate = expRate;
     this->decayGamma = decayGamma;
     this->learningRate = learningRate;
+    this->lambda = -1.0f;
 
-    this->gameStates = new std::string[board->cellsCount];
+    this->gameStates = std::vector<uint64_t>(board->cellsCount);
     this->gameStatesSize = 0;
-    this->svPairs = {};
+    this->availableActions = std::vector<pos>(board->cellsCount);
+    this->actionKeys = std::vector<uint64_t>(board->cellsCount);
+    this->svPairs = std::make_shared<ValueTable>();
+    this->twoSided = false;
+    this->prior = nullptr;
+    this->sweeper = nullptr;
+    this->updatesCount = 0;
+    this->newStatesCount = 0;
+    this->deltaSum = 0.0;
 }
 
 /**
@@ -31,22 +43,40 @@ Agent::Agent(Board *board, char tag, float expRate, float decayGamma, float lear
  * @return the chosen action coordinates
  */
 pos Agent::chooseAction(bool fightMode, bool debugMode) {
+    return chooseAction(*board, fightMode, debugMode);
+}
+
+/**
+ * Choose an action on a board other than the agent one,
+ * used to play many games at the same time
+ * @param b the board where the action will be performed
+ * @param fightMode if true, the ai will not try new
+ * unknown actions
+ * @param debugMode if true, extra information about the
+ * decision process will be shown
+ * @return the chosen action coordinates
+ */
+pos Agent::chooseAction(Board &b, bool fightMode, bool debugMode) {
     pos action;
-    pos *availableActions = new pos[board->cellsCount];
-    int availableActionsCount = board->getAvailableActions(availableActions);
+    int availableActionsCount = b.getAvailableActions(availableActions.data());
     if (availableActionsCount == 0) {
         throw std::out_of_range("No actions available");
     }
 
-    if (!fightMode && board->randomUnitFloat() <= expRate) {
-        action = availableActions[board->randomInt(availableActionsCount)];
+    if (!fightMode && b.randomUnitFloat() <= expRate) {
+        action = availableActions[b.randomInt(availableActionsCount)];
     } else {
-        float maxValue = -9999.0f;
+        // Start loading every candidate before reading the first one
+        const ValueTable &table = *svPairs;
         for (int i = 0; i < availableActionsCount; i++) {
-            std::string nextHash = board->getStateHash(tag, availableActions[i]);
+            actionKeys[i] = b.getStateKey(tag, availableActions[i]);
+            table.prefetch(actionKeys[i]);
+        }
 
-            auto pair = svPairs.find(nextHash);
-            float value = pair != svPairs.end() ? pair->second : 0.0f;
+        float maxValue = -9999.0f;
+        for (int i = 0; i < availableActionsCount; i++) {
+            const float *found = table.find(actionKeys[i]);
+            float value = found != nullptr ? *found : (prior != nullptr ? priorValue(actionKeys[i]) : 0.0f);
 
             if (debugMode)
                 printf("[DEBUG] Evaluating action (%d, %d): %.4f\n", availableActions[i].x, availableActions[i].y,
@@ -61,38 +91,197 @@ pos Agent::chooseAction(bool fightMode, bool debugMode) {
         if (debugMode) printf("[DEBUG] Chosen action (%d, %d): %.4f\n", action.x, action.y, maxValue);
     }
 
-    delete[] availableActions;
     return action;
 }
 
+/**
+ * Find the action chosen in fight mode without touching the
+ * agent buffers, so it can be called from other threads
+ * while nobody is training the agent
+ * @param b the board where the action will be performed
+ * @return the chosen action coordinates
+ */
+pos Agent::bestAction(Board &b) const {
+    std::vector<pos> actions(b.cellsCount);
+    int actionsCount = b.getAvailableActions(actions.data());
+    if (actionsCount == 0) {
+        throw std::out_of_range("No actions available");
+    }
+
+    pos action = actions[0];
+    float maxValue = -9999.0f;
+    for (int i = 0; i < actionsCount; i++) {
+        const float *found = values().find(b.getStateKey(tag, actions[i]));
+        float value = found != nullptr ? *found : 0.0f;
+        if (value >= maxValue) {
+            maxValue = value;
+            action = actions[i];
+        }
+    }
+
+    return action;
+}
+
+/**
+ * Start loading the values of every action available on
+ * a board, so that the next chooseAction on it does not
+ * wait for memory
+ * @param b the board where the action will be performed
+ */
+void Agent::prefetchActions(Board &b) {
+    int availableActionsCount = b.getAvailableActions(availableActions.data());
+    for (int i = 0; i < availableActionsCount; i++) svPairs->prefetch(b.getStateKey(tag, availableActions[i]));
+}
+
+/**
+ * Start loading the values of some states
+ * @param states the states keys
+ * @param statesCount number of states
+ */
+void Agent::prefetchStates(const uint64_t *states, int statesCount) const {
+    for (int i = 0; i < statesCount; i++) svPairs->prefetch(states[i]);
+}
+
 /**
  * Give the agent a reward or punishment
  * @param reward the positive or negative reward
  */
 void Agent::feedReward(float reward) {
-    float _reward = reward;
-    for (int i = gameStatesSize - 1; i >= 0; i--) {
-        std::string state = gameStates[i];
+    feedReward(reward, gameStates.data(), gameStatesSize);
+}
 
-        auto pair = svPairs.find(state);
-        if (pair != svPairs.end()) {
-            pair->second += learningRate * (decayGamma * _reward - pair->second);
-            _reward = pair->second;
-        } else {
-            float initialValue = learningRate * (decayGamma * _reward);
-            svPairs.insert(std::pair<std::string, float>(state, initialValue));
+/**
+ * Give the agent a reward or punishment for a game
+ * played outside of its own game states
+ * @param reward the positive or negative reward
+ * @param states the states of the game, in order
+ * @param statesCount number of states
+ */
+void Agent::feedReward(float reward, const uint64_t *states, int statesCount) {
+    if (lambda >= 0.0f) {
+        feedLambdaReturns(reward, states, statesCount);
+        return;
+    }
+
+    float _reward = reward;
+    for (int i = statesCount - 1; i >= 0; i--) {
+        bool inserted;
+        float *value = svPairs->findOrInsert(states[i], 0.0f, inserted);
+        float delta;
+        if (inserted && prior == nullptr) {
+            delta = learningRate * (decayGamma * _reward);
+            *value = delta;
             _reward = 0.0f;
+        } else {
+            // A new state with a prior is updated as if it was already known
+            if (inserted) *value = prior->estimate(states[i], tag);
+
+            delta = learningRate * (decayGamma * _reward - *value);
+            *value += delta;
+            _reward = *value;
         }
+        deltaSum += std::fabs(delta);
+        if (sweeper != nullptr) sweeper->changed(states[i], delta);
+
+        if (inserted) newStatesCount++;
+        updatesCount++;
     }
 }
 
+/**
+ * Move the states of a game towards their lambda-returns, in a
+ * single backward pass: the return of a state mixes the value
+ * and the return of the next one, so the reward reaches every
+ * state of the game, even the ones that were just discovered.
+ * It is the offline form of TD(lambda) with eligibility traces.
+ * @param reward the positive or negative reward
+ * @param states the states of the game, in order
+ * @param statesCount number of states
+ */
+void Agent::feedLambdaReturns(float reward, const uint64_t *states, int statesCount) {
+    float nextReturn = reward, nextValue = reward;
+    for (int i = statesCount - 1; i >= 0; i--) {
+        bool inserted;
+        float *value = svPairs->findOrInsert(states[i], 0.0f, inserted);
+        if (inserted && prior != nullptr) *value = prior->estimate(states[i], tag);
+
+        float target = decayGamma * ((1.0f - lambda) * nextValue + lambda * nextReturn);
+        float delta = learningRate * (target - *value);
+        *value += delta;
+        nextReturn = target;
+        nextValue = *value;
+
+        deltaSum += std::fabs(delta);
+        if (sweeper != nullptr) sweeper->changed(states[i], delta);
+        if (inserted) newStatesCount++;
+        updatesCount++;
+    }
+}
+
+/**
+ * Change how the agent learns from rewards
+ * @param _decayGamma the new value of future reward
+ * @param _learningRate the new learning rate
+ */
+void Agent::setLearningParams(float _decayGamma, float _learningRate) {
+    this->decayGamma = _decayGamma;
+    this->learningRate = _learningRate;
+}
+
+/**
+ * @return the value of future reward
+ */
+float Agent::getDecayGamma() const {
+    return decayGamma;
+}
+
+/**
+ * @return the learning rate
+ */
+float Agent::getLearningRate() const {
+    return learningRate;
+}
+
+/**
+ * Choose how far the reward of a game is carried back
+ * @param _lambda the trace decay of TD(lambda), from 0 (only
+ * the value of the next state) to 1 (the discounted reward),
+ * or a negative value for the classic update, where a newly
+ * discovered state does not pass the reward back
+ */
+void Agent::setTraceDecay(float _lambda) {
+    this->lambda = _lambda;
+}
+
+/**
+ * @return the trace decay, negative for the classic update
+ */
+float Agent::getTraceDecay() const {
+    return lambda;
+}
+
+/**
+ * Get the learning statistics collected since the last call
+ * and reset them
+ * @param meanDelta mean absolute change of the values per update
+ * @param discoveryRate fraction of updates that created a new state
+ */
+void Agent::takeLearningStats(double &meanDelta, double &discoveryRate) {
+    meanDelta = updatesCount > 0 ? deltaSum / (double) updatesCount : 0.0;
+    discoveryRate = updatesCount > 0 ? (double) newStatesCount / (double) updatesCount : 0.0;
+
+    updatesCount = 0;
+    newStatesCount = 0;
+    deltaSum = 0.0;
+}
+
 /**
  * Add a state to the agent for the current game
  * @param state current state
  */
-void Agent::addGameState(std::string state) {
+void Agent::addGameState(uint64_t state) {
     if (gameStatesSize < board->cellsCount) {
-        gameStates[gameStatesSize] = std::move(state);
+        gameStates[gameStatesSize] = state;
         gameStatesSize++;
     } else throw std::out_of_range("gameStates array filled.");
 }
@@ -109,14 +298,14 @@ void Agent::newGame() {
  * @param full if true, more info will be shown
  */
 void Agent::debug(bool full) {
-    printf("Agent %p [%c]\n", this, tag);
-    printf("svPairsSize: %lu\n", svPairs.size());
+    printf("Agent %p [%c]\n", this, twoSided ? Board::BOTH : tag);
+    printf("svPairsSize: %lu\n", svPairs->size());
 
     if (full) {
         int i = 0;
-        for (std::pair<std::string, float> entry: svPairs) {
-            printf("[%d] '%s' --> %.6f\n", i++, entry.first.c_str(), entry.second);
-        }
+        svPairs->forEach([&](uint64_t key, float value) {
+            printf("[%d] '%s' --> %.6f\n", i++, board->keyToHash(key).c_str(), value);
+        });
     }
 }
 
@@ -128,11 +317,12 @@ void Agent::save(const std::string &fileName) {
     FILE *f;
     f = fopen(fileName.c_str(), "w");
 
-    fprintf(f, "%d\n%d\n%c\n%f\n%f\n%f\n", board->l, board->winStr, tag, expRate, decayGamma, learningRate);
-    for (std::pair<std::string, float> entry: svPairs) {
-        fprintf(f, "%s\n", entry.first.c_str());
-        fprintf(f, "%f\n", entry.second);
-    }
+    fprintf(f, "%d\n%d\n%c\n%f\n%f\n%f\n", board->l, board->winStr,
+            twoSided ? Board::BOTH : tag, expRate, decayGamma, learningRate);
+    svPairs->forEach([&](uint64_t key, float value) {
+        fprintf(f, "%s\n", board->keyToHash(key).c_str());
+        fprintf(f, "%f\n", value);
+    });
 
     fclose(f);
 }
@@ -154,31 +344,160 @@ void Agent::load(const std::string &fileName) {
     int i = 0;
     size_t len = 0;
     char *line = nullptr;
-    std::string lastState;
+    uint64_t lastState = UINT64_MAX;
     while (getline(&line, &len, f) != -1) {
         switch (i) {
+            case 0:
+            case 1:
+                break;
             case 2:
-                tag = line[0];
+                twoSided = line[0] == Board::BOTH;
+                if (!twoSided) tag = line[0];
                 break;
             case 3:
                 expRate = atof(line);
+                break;
             case 4:
                 decayGamma = atof(line);
+                break;
             case 5:
                 learningRate = atof(line);
+                break;
             default:
-                if (i % 2 == 0 && len > 0) lastState = std::string(line).substr(0, board->cellsCount);
-                else svPairs.insert(std::pair<std::string, float>(lastState, atof(line)));
+                if (i % 2 == 0) {
+                    lastState = board->hashToKey(line);
+                } else if (lastState != UINT64_MAX) {
+                    bool inserted;
+                    *svPairs->findOrInsert(lastState, 0.0f, inserted) = atof(line);
+                }
                 break;
         }
         i++;
     }
+    free(line);
 
     fclose(f);
 }
 
+/**
+ * Change the probability of trying a random action
+ * @param _expRate the new exploration rate
+ */
 void Agent::setExplorationRate(float _expRate) {
-    this->expRate = expRate;
+    this->expRate = _expRate;
+}
+
+/**
+ * Get the probability of trying a random action
+ * @return the exploration rate
+ */
+float Agent::getExplorationRate() const {
+    return expRate;
+}
+
+/**
+ * Make two agents use the same table, so that a single file
+ * plays both X and O. The afterstates of X always have one
+ * more X than O and those of O the same number of both, so
+ * the position alone tells which side each entry belongs to.
+ * @param other the agent whose table will be shared
+ */
+void Agent::shareValues(Agent &other) {
+    svPairs = other.svPairs;
+    twoSided = true;
+    other.twoSided = true;
+}
+
+/**
+ * Copy the agent with a snapshot of its values, that can be
+ * read by another thread while this agent keeps learning. It
+ * must be called by the thread that updates this agent.
+ * @param _board the board of the copy
+ * @return the copy, whose table is not shared with other agents
+ */
+Agent Agent::snapshot(Board *_board) const {
+    Agent copy = Agent(_board, tag, expRate, decayGamma, learningRate);
+    copy.svPairs = std::make_shared<ValueTable>(*svPairs);
+    copy.prior = prior;
+    copy.lambda = lambda;
+    return copy;
+}
+
+/**
+ * @return true if the agent table holds the values of both sides
+ */
+bool Agent::isTwoSided() const {
+    return twoSided;
+}
+
+/**
+ * Use the values of another agent as the initial values of
+ * the unknown states
+ * @param _prior the initial values, or nullptr for 0
+ */
+void Agent::setPrior(const ValuePrior *_prior) {
+    this->prior = _prior;
+    priorValues.clear();
+}
+
+/**
+ * Prior estimate of an unknown state, remembered until it is
+ * written in the table by keepPriorValues
+ * @param key state key
+ * @return the prior estimate
+ */
+float Agent::priorValue(uint64_t key) {
+    bool inserted;
+    float *value = priorValues.findOrInsert(key, 0.0f, inserted);
+    if (inserted) *value = prior->estimate(key, tag);
+    return *value;
+}
+
+/**
+ * Add to the table the prior estimate of every unknown state
+ * that was evaluated while choosing an action. The prior is not
+ * saved, so without them a saved agent would see 0 for these
+ * states and choose differently than during the training.
+ */
+void Agent::keepPriorValues() {
+    priorValues.forEach([&](uint64_t key, float value) {
+        bool inserted;
+        svPairs->findOrInsert(key, value, inserted);
+    });
+    priorValues.clear();
+}
+
+/**
+ * Let a sweeper know about every value changed by the rewards,
+ * so that it can update the states that lead to them
+ * @param _sweeper the sweeper, or nullptr for none
+ */
+void Agent::setSweeper(Sweeper *_sweeper) {
+    this->sweeper = _sweeper;
+}
+
+/**
+ * Value of a state as seen when choosing an action
+ * @param key state key
+ * @return the known value, or the prior estimate, or 0
+ */
+float Agent::valueOf(uint64_t key) const {
+    const float *found = values().find(key);
+    return found != nullptr ? *found : (prior != nullptr ? prior->estimate(key, tag) : 0.0f);
+}
+
+/**
+ * @return the table of the known states values
+ */
+ValueTable &Agent::values() {
+    return *svPairs;
+}
+
+/**
+ * @return the table of the known states values
+ */
+const ValueTable &Agent::values() const {
+    return *svPairs;
 }
 
 Agent::~Agent() = default;
\ No newline at end of file
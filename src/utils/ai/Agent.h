@@ -1,31 +1,61 @@
 #ifndef TICTACTOEAI_AGENT_H
 #define TICTACTOEAI_AGENT_H
 
-#include <map>
+#include <memory>
+#include "ValueTable.h"
 #include "../board/Board.h"
 
+class ValuePrior;
+
+class Sweeper;
+
 class Agent {
 private:
     Board *board;
     float expRate;
     float decayGamma;
     float learningRate;
-    std::string *gameStates;
+    float lambda;
+    std::vector<uint64_t> gameStates;
     int gameStatesSize;
-    std::map<std::string, float> svPairs;
+    std::vector<pos> availableActions;
+    std::vector<uint64_t> actionKeys;
+    std::shared_ptr<ValueTable> svPairs;
+    bool twoSided;
+    const ValuePrior *prior;
+    ValueTable priorValues;
+    Sweeper *sweeper;
+    long updatesCount;
+    long newStatesCount;
+    double deltaSum;
+
+    void feedLambdaReturns(float, const uint64_t *, int);
+
+    float priorValue(uint64_t);
 
 public:
     char tag;
 
     explicit Agent(Board *, char = Board::NONE, float = 0.3, float = 0.9, float = 0.2);
 
+    // A copy would share the table, snapshot makes an independent one
+    Agent(const Agent &) = delete;
+
+    Agent(Agent &&) = default;
+
     ~Agent();
 
+    Agent &operator=(const Agent &) = delete;
+
+    Agent &operator=(Agent &&) = default;
+
     void feedReward(float);
 
+    void feedReward(float, const uint64_t *, int);
+
     void newGame();
 
-    void addGameState(std::string state);
+    void addGameState(uint64_t state);
 
     void debug(bool full = false);
 
@@ -35,7 +65,47 @@ public:
 
     pos chooseAction(bool = false, bool = false);
 
+    pos chooseAction(Board &, bool = false, bool = false);
+
+    pos bestAction(Board &) const;
+
+    void prefetchActions(Board &);
+
+    void prefetchStates(const uint64_t *, int) const;
+
     void setExplorationRate(float _expRate);
+
+    float getExplorationRate() const;
+
+    void setLearningParams(float _decayGamma, float _learningRate);
+
+    float getDecayGamma() const;
+
+    float getLearningRate() const;
+
+    void setTraceDecay(float);
+
+    float getTraceDecay() const;
+
+    void takeLearningStats(double &meanDelta, double &discoveryRate);
+
+    void shareValues(Agent &);
+
+    Agent snapshot(Board *) const;
+
+    bool isTwoSided() const;
+
+    void setPrior(const ValuePrior *);
+
+    void keepPriorValues();
+
+    void setSweeper(Sweeper *);
+
+    float valueOf(uint64_t) const;
+
+    ValueTable &values();
+
+    const ValueTable &values() const;
 };
 
 
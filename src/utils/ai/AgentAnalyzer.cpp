@@ -0,0 +1,209 @@
+#include <iostream>
+#include <cmath>
+#include <algorithm>
+#include "AgentAnalyzer.h"
+
+#define HISTOGRAM_BINS 20
+#define HISTOGRAM_WIDTH 40
+
+/**
+ * Offline inspection and compaction of a trained agent
+ * @param agent The agent to analyze
+ * @param l Size of the board of the agent
+ * @param winStr Consecutive symbols needed to win
+ */
+AgentAnalyzer::AgentAnalyzer(Agent *agent, int l, int winStr) : board(l, winStr) {
+    this->agent = agent;
+    this->opponent = agent->tag == Board::X ? Board::O : Board::X;
+}
+
+/**
+ * Print the states count by depth, the values histogram, the
+ * memory used and the states that can never occur in a game
+ * @param fileBytes size of the agent file
+ */
+void AgentAnalyzer::report(long fileBytes) {
+    ValueTable &values = agent->values();
+
+    std::vector<long> depths(board.cellsCount + 1, 0);
+    std::vector<long> bins(HISTOGRAM_BINS, 0);
+    long kinds[3] = {0, 0, 0};
+    float minValue = 0.0f, maxValue = 0.0f;
+    values.forEach([&](uint64_t key, float value) {
+        std::string hash = board.keyToHash(key);
+        depths[board.cellsCount - std::count(hash.begin(), hash.end(), Board::NONE)]++;
+
+        int bin = (int) std::floor((value + 1.0f) / 2.0f * HISTOGRAM_BINS);
+        bins[std::min(std::max(bin, 0), HISTOGRAM_BINS - 1)]++;
+        minValue = std::min(minValue, value);
+        maxValue = std::max(maxValue, value);
+
+        kinds[classify(key)]++;
+    });
+
+    size_t size = std::max(values.size(), (size_t) 1);
+    printf("States: %lu\n", values.size());
+    printf("Memory: %lu bytes (%.1f per state)\n", values.capacity() * 16, values.capacity() * 16.0 / size);
+    printf("File:   %ld bytes (%.1f per state)\n", fileBytes, (double) fileBytes / size);
+
+    printf("\nStates by depth:\n");
+    for (int d = 0; d <= board.cellsCount; d++)
+        if (depths[d] > 0) printf("%3d: %ld\n", d, depths[d]);
+
+    printf("\nValues (min %.4f, max %.4f):\n", minValue, maxValue);
+    long maxBin = *std::max_element(bins.begin(), bins.end());
+    for (int i = 0; i < HISTOGRAM_BINS; i++) {
+        float from = -1.0f + 2.0f * i / HISTOGRAM_BINS;
+        int width = maxBin > 0 ? (int) (bins[i] * HISTOGRAM_WIDTH / maxBin) : 0;
+        printf("[%5.2f, %5.2f) %9ld %s\n", from, from + 2.0f / HISTOGRAM_BINS, bins[i], std::string(width, '#').c_str());
+    }
+
+    printf("\nUnreachable states: %ld\n", kinds[INVALID_COUNTS] + kinds[AFTER_GAME_OVER]);
+    printf("  invalid X/O counts:       %ld\n", kinds[INVALID_COUNTS]);
+    printf("  reached after a game end: %ld\n", kinds[AFTER_GAME_OVER]);
+}
+
+/**
+ * Print the hashes of the states that can never occur in a
+ * game, grouped by the reason
+ */
+void AgentAnalyzer::listUnreachable() {
+    std::vector<std::string> invalidCounts, afterGameOver;
+    agent->values().forEach([&](uint64_t key, float) {
+        int kind = classify(key);
+        if (kind == INVALID_COUNTS) invalidCounts.push_back(board.keyToHash(key));
+        else if (kind == AFTER_GAME_OVER) afterGameOver.push_back(board.keyToHash(key));
+    });
+    std::sort(invalidCounts.begin(), invalidCounts.end());
+    std::sort(afterGameOver.begin(), afterGameOver.end());
+
+    printf("\nInvalid X/O counts:\n");
+    for (const std::string &hash: invalidCounts) printf("  %s\n", hash.c_str());
+    printf("\nReached after a game end:\n");
+    for (const std::string &hash: afterGameOver) printf("  %s\n", hash.c_str());
+}
+
+/**
+ * Remove the states that can never be looked up and the
+ * values so close to zero that dropping them does not change
+ * any choice of the agent
+ * @param maxValue only values whose magnitude is at most this
+ * are considered for removal
+ */
+void AgentAnalyzer::compact(float maxValue) {
+    ValueTable &values = agent->values();
+
+    std::vector<uint64_t> keys;
+    keys.reserve(values.size());
+    values.forEach([&](uint64_t key, float) { keys.push_back(key); });
+
+    long unreachable = 0, negligible = 0;
+    for (uint64_t key: keys) {
+        if (classify(key) != REACHABLE) {
+            values.erase(key);
+            unreachable++;
+        } else if (std::fabs(*values.find(key)) <= maxValue && keepsChoices(key)) {
+            values.erase(key);
+            negligible++;
+        }
+    }
+    values.shrinkToFit();
+
+    printf("Removed %ld unreachable and %ld negligible states, %lu left\n", unreachable, negligible,
+           values.size());
+}
+
+/**
+ * Check if a state has the X/O counts of a choice of the
+ * agent. A two-sided agent is switched to the side that
+ * made the last move of the state.
+ * @param key state key
+ * @return false if the counts are not valid
+ */
+bool AgentAnalyzer::selectSide(uint64_t key) {
+    std::string hash = board.keyToHash(key);
+    long xs = std::count(hash.begin(), hash.end(), Board::X);
+    long os = std::count(hash.begin(), hash.end(), Board::O);
+
+    if (agent->isTwoSided()) {
+        if (xs != os + 1 && xs != os) return false;
+        agent->tag = xs > os ? Board::X : Board::O;
+        opponent = xs > os ? Board::O : Board::X;
+        return true;
+    }
+
+    return agent->tag == Board::X ? xs == os + 1 : xs == os;
+}
+
+/**
+ * Check if a state can occur as a choice of the agent
+ * @param key state key
+ * @return REACHABLE, INVALID_COUNTS or AFTER_GAME_OVER
+ */
+int AgentAnalyzer::classify(uint64_t key) {
+    if (!selectSide(key)) return INVALID_COUNTS;
+    std::string hash = board.keyToHash(key);
+
+    // Any subset of a position without streaks has no streaks
+    // either, so only the last move has to be checked
+    board.setState(key);
+    if (board.hasStreak(opponent)) return AFTER_GAME_OVER;
+    if (!board.hasStreak(agent->tag)) return REACHABLE;
+
+    for (int i = 0; i < board.cellsCount; i++) {
+        if (hash[i] != agent->tag) continue;
+
+        hash[i] = Board::NONE;
+        board.setState(board.hashToKey(hash));
+        hash[i] = agent->tag;
+        if (!board.hasStreak(agent->tag)) return REACHABLE;
+    }
+
+    return AFTER_GAME_OVER;
+}
+
+/**
+ * The cell chosen by the agent in fight mode
+ * @param key state key where the agent has to move
+ * @return index of the chosen cell
+ */
+int AgentAnalyzer::chooseCell(uint64_t key) {
+    board.setState(key);
+    pos action = agent->bestAction(board);
+    return action.y * board.l + action.x;
+}
+
+/**
+ * Check if the agent makes the same choices without a state,
+ * in every position where it could be chosen
+ * @param key state key
+ * @return true if the state can be removed
+ */
+bool AgentAnalyzer::keepsChoices(uint64_t key) {
+    selectSide(key);
+    float *value = agent->values().find(key);
+    float saved = *value;
+    if (saved == 0.0f) return true;
+
+    std::string hash = board.keyToHash(key);
+    bool keeps = true;
+    for (int i = 0; i < board.cellsCount && keeps; i++) {
+        if (hash[i] != agent->tag) continue;
+
+        hash[i] = Board::NONE;
+        uint64_t parent = board.hashToKey(hash);
+        hash[i] = agent->tag;
+
+        board.setState(parent);
+        if (board.getGameStatus() != 0) continue;
+
+        // A missing state is worth exactly 0, like a removed one
+        int before = chooseCell(parent);
+        *value = 0.0f;
+        int after = chooseCell(parent);
+        *value = saved;
+        keeps = before == after;
+    }
+
+    return keeps;
+}
@@ -0,0 +1,35 @@
+#ifndef TICTACTOEAI_AGENTANALYZER_H
+#define TICTACTOEAI_AGENTANALYZER_H
+
+#include "Agent.h"
+
+class AgentAnalyzer {
+private:
+    Agent *agent;
+    Board board;
+    char opponent;
+
+    bool selectSide(uint64_t);
+
+    int classify(uint64_t);
+
+    int chooseCell(uint64_t);
+
+    bool keepsChoices(uint64_t);
+
+public:
+    static const int REACHABLE = 0;
+    static const int INVALID_COUNTS = 1;
+    static const int AFTER_GAME_OVER = 2;
+
+    AgentAnalyzer(Agent *, int, int);
+
+    void report(long fileBytes);
+
+    void listUnreachable();
+
+    void compact(float maxValue);
+};
+
+
+#endif //TICTACTOEAI_AGENTANALYZER_H
@@ -0,0 +1,88 @@
+#include "Ponderer.h"
+
+/**
+ * Works out the replies of an agent while the opponent is
+ * thinking, on a background thread
+ * @param agent The agent that will reply
+ * @param l Size of the board
+ * @param winStr Consecutive symbols needed to win
+ */
+Ponderer::Ponderer(const Agent *agent, int l, int winStr) : board(l, winStr) {
+    this->agent = agent;
+    this->cancelled = false;
+    this->replies = std::vector<pos>(board.cellsCount);
+    this->ready = std::vector<char>(board.cellsCount, 0);
+    this->hits = 0;
+    this->misses = 0;
+}
+
+/**
+ * Start computing the reply to every legal move of the
+ * opponent. The replies already computed for the same
+ * position are kept.
+ * @param current The board where the opponent has to move
+ */
+void Ponderer::start(const Board &current) {
+    if (worker.joinable()) stop();
+
+    if (current.getStateKey() != board.getStateKey() || current.getMovesCount() != board.getMovesCount()) {
+        board = current;
+        std::fill(ready.begin(), ready.end(), 0);
+    }
+
+    cancelled = false;
+    worker = std::thread(&Ponderer::run, this, current.turn);
+}
+
+/**
+ * Cancel the computation and wait for the thread to end
+ */
+void Ponderer::stop() {
+    cancelled = true;
+    if (worker.joinable()) worker.join();
+}
+
+/**
+ * Take the precomputed reply to a move of the opponent
+ * @param cell the cell of the opponent move, y * l + x
+ * @param action where the reply will be put
+ * @return false if the reply was not computed in time
+ */
+bool Ponderer::reply(int cell, pos &action) {
+    std::lock_guard<std::mutex> lock(repliesMutex);
+    if (!ready[cell]) {
+        misses++;
+        return false;
+    }
+
+    action = replies[cell];
+    hits++;
+    return true;
+}
+
+/**
+ * Body of the background thread
+ * @param opponent tag of the player that has to move
+ */
+void Ponderer::run(char opponent) {
+    std::vector<pos> actions(board.cellsCount);
+    int actionsCount = board.getAvailableActions(actions.data());
+
+    for (int i = 0; i < actionsCount && !cancelled; i++) {
+        int cell = actions[i].y * board.l + actions[i].x;
+        if (ready[cell]) continue;
+
+        Board next = board;
+        next.performAction(opponent, actions[i]);
+        if (next.getGameStatus() != 0) continue;
+
+        pos action = agent->bestAction(next);
+        std::lock_guard<std::mutex> lock(repliesMutex);
+        replies[cell] = action;
+        ready[cell] = 1;
+    }
+}
+
+Ponderer::~Ponderer() {
+    stop();
+}
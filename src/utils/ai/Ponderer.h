@@ -0,0 +1,37 @@
+#ifndef TICTACTOEAI_PONDERER_H
+#define TICTACTOEAI_PONDERER_H
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include "Agent.h"
+
+class Ponderer {
+private:
+    const Agent *agent;
+    Board board;
+    std::thread worker;
+    std::atomic<bool> cancelled;
+    std::mutex repliesMutex;
+    std::vector<pos> replies;
+    std::vector<char> ready;
+
+    void run(char);
+
+public:
+    long hits;
+    long misses;
+
+    Ponderer(const Agent *, int, int);
+
+    ~Ponderer();
+
+    void start(const Board &);
+
+    void stop();
+
+    bool reply(int, pos &);
+};
+
+
+#endif //TICTACTOEAI_PONDERER_H
@@ -0,0 +1,241 @@
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include "Sweeper.h"
+
+#define SWEEP_MIN_PRIORITY 3e-2f    // expected changes below this are not queued
+
+/**
+ * Prioritized sweeping: queues the states whose values are
+ * expected to change the most because a state that follows
+ * them changed, and updates them between games with a backup
+ * over every reply of the opponent
+ * @param agent The agent whose values are updated
+ * @param opponent The agent that plays the replies
+ * @param l Size of the board
+ * @param winStr Consecutive symbols needed to win
+ * @param win Reward of a won game
+ * @param loss Reward of a lost game
+ * @param draw Reward of a draw
+ * @param capacity Number of queued states above which the
+ * least promising ones are dropped
+ */
+Sweeper::Sweeper(Agent *agent, const Agent *opponent, int l, int winStr, float win, float loss, float draw,
+                 size_t capacity) : board(l, winStr) {
+    this->agent = agent;
+    this->opponent = opponent;
+    this->win = win;
+    this->loss = loss;
+    this->draw = draw;
+    this->capacity = capacity;
+    this->replies = std::vector<pos>(board.cellsCount);
+    this->cells = std::vector<int>(board.cellsCount);
+    this->ownWins = std::vector<char>(board.cellsCount);
+    this->parents = std::vector<uint64_t>((board.cellsCount + 1) * (board.cellsCount + 1) / 4);
+    this->backups = 0;
+
+    uint64_t weight = 1;
+    for (int i = 0; i < board.cellsCount; i++) {
+        weights.push_back(weight);
+        weight *= 3;
+    }
+}
+
+/**
+ * Queue the known states from which a changed state is reached
+ * with one move of the opponent and one of the agent. They are
+ * found by removing one symbol of each side from its key.
+ * @param key the changed state
+ * @param delta the change of its value
+ */
+void Sweeper::changed(uint64_t key, float delta) {
+    float priority = agent->getDecayGamma() * std::fabs(delta);
+    if (priority < SWEEP_MIN_PRIORITY) return;
+
+    const uint64_t own = agent->tag == Board::X ? 1 : 2;
+    int ownCells[Board::MAX_CELLS], otherCells[Board::MAX_CELLS];
+    int ownCount = 0, otherCount = 0;
+    uint64_t digits = key;
+    for (int i = 0; i < board.cellsCount; i++) {
+        uint64_t digit = digits % 3;
+        if (digit == own) ownCells[ownCount++] = i;
+        else if (digit != 0) otherCells[otherCount++] = i;
+        digits /= 3;
+    }
+
+    // The first move of the agent has no parent
+    if (ownCount < 2) return;
+
+    const ValueTable &values = agent->values();
+    int parentsCount = 0;
+    for (int i = 0; i < ownCount; i++) {
+        for (int j = 0; j < otherCount; j++) {
+            parents[parentsCount] = key - own * weights[ownCells[i]] - (3 - own) * weights[otherCells[j]];
+            values.prefetch(parents[parentsCount++]);
+        }
+    }
+
+    for (int i = 0; i < parentsCount; i++)
+        if (values.find(parents[i]) != nullptr) push(parents[i], priority);
+}
+
+/**
+ * Queue a state, or raise its priority if it is already queued
+ * @param key state key
+ * @param priority expected change of its value
+ */
+void Sweeper::push(uint64_t key, float priority) {
+    bool inserted;
+    float *queuedPriority = queued.findOrInsert(key, priority, inserted);
+    if (!inserted) {
+        if (*queuedPriority >= priority) return;
+        *queuedPriority = priority;
+    }
+
+    heap.emplace_back(priority, key);
+    std::push_heap(heap.begin(), heap.end());
+    if (heap.size() > 2 * capacity) trim();
+}
+
+/**
+ * Keep only the states with the highest priorities
+ */
+void Sweeper::trim() {
+    std::nth_element(heap.begin(), heap.begin() + capacity, heap.end(),
+                     std::greater<std::pair<float, uint64_t>>());
+    heap.resize(capacity);
+    std::make_heap(heap.begin(), heap.end());
+
+    queued.clear();
+    for (const std::pair<float, uint64_t> &entry: heap) {
+        bool inserted;
+        float *queuedPriority = queued.findOrInsert(entry.second, entry.first, inserted);
+        if (!inserted) *queuedPriority = std::max(*queuedPriority, entry.first);
+    }
+}
+
+/**
+ * Update the queued states with the highest priorities
+ * @param maxBackups maximum number of states to update
+ * @return the number of updated states
+ */
+int Sweeper::sweep(int maxBackups) {
+    int done = 0;
+    while (done < maxBackups && !heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end());
+        uint64_t key = heap.back().second;
+        heap.pop_back();
+
+        // Lower duplicates of a state that was already updated
+        if (!queued.erase(key)) continue;
+
+        float newValue = target(key);
+        float *value = agent->values().find(key);
+        if (value == nullptr) continue;
+
+        float delta = agent->getLearningRate() * (newValue - *value);
+        *value += delta;
+        backups++;
+        done++;
+        changed(key, delta);
+    }
+
+    return done;
+}
+
+/**
+ * @return the number of queued states
+ */
+size_t Sweeper::pending() const {
+    return queued.size();
+}
+
+/**
+ * Reward of the agent at the end of a game
+ * @param status final status of the game
+ * @return the reward
+ */
+float Sweeper::reward(int status) const {
+    if (status == 3) return draw;
+    if ((status == 1 && agent->tag == Board::X) || (status == 2 && agent->tag == Board::O)) return win;
+    return loss;
+}
+
+/**
+ * Value that a state is expected to take after one more game
+ * through it: the opponent replies like its exploring greedy
+ * policy, and the agent answers like its own
+ * @param key state key
+ * @return the discounted value of what follows the state
+ */
+float Sweeper::target(uint64_t key) {
+    const float gamma = agent->getDecayGamma();
+    board.setState(key);
+    int status = board.getGameStatus();
+    if (status != 0) return gamma * reward(status);
+
+    const char other = agent->tag == Board::X ? Board::O : Board::X;
+    const uint64_t otherDigit = other == Board::X ? 1 : 2;
+    int emptyCount = board.getAvailableActions(replies.data());
+    for (int i = 0; i < emptyCount; i++) {
+        cells[i] = replies[i].y * board.l + replies[i].x;
+        // A reply of the opponent never changes the moves that win for the agent
+        ownWins[i] = board.isWinningAction(agent->tag, replies[i]);
+    }
+
+    // Start loading every value of the backup before reading the first one
+    for (int i = 0; i < emptyCount; i++) {
+        uint64_t afterReply = key + otherDigit * weights[cells[i]];
+        opponent->values().prefetch(afterReply);
+        for (int j = 0; j < emptyCount; j++)
+            if (j != i) agent->values().prefetch(afterReply + (3 - otherDigit) * weights[cells[j]]);
+    }
+
+    float sum = 0.0f, greedy = 0.0f, maxValue = -9999.0f;
+    for (int i = 0; i < emptyCount; i++) {
+        uint64_t afterReply = key + otherDigit * weights[cells[i]];
+        float outcome;
+        if (board.isWinningAction(other, replies[i])) outcome = loss;
+        else if (emptyCount == 1) outcome = draw;
+        else outcome = bestValue(afterReply, i, emptyCount);
+
+        float replyValue = opponent->valueOf(afterReply);
+        if (replyValue >= maxValue) {
+            maxValue = replyValue;
+            greedy = outcome;
+        }
+        sum += outcome;
+    }
+
+    float expRate = opponent->getExplorationRate();
+    return gamma * ((1.0f - expRate) * greedy + expRate * sum / (float) emptyCount);
+}
+
+/**
+ * Value of the move of the agent after a reply of the opponent,
+ * as chosen by its exploring greedy policy. A move that ends
+ * the game is worth what its value converges to.
+ * @param afterReply state key after the reply
+ * @param reply index of the cell taken by the reply
+ * @param emptyCount number of empty cells before the reply
+ * @return the expected value of the next state
+ */
+float Sweeper::bestValue(uint64_t afterReply, int reply, int emptyCount) {
+    const float gamma = agent->getDecayGamma();
+    const uint64_t ownDigit = agent->tag == Board::X ? 1 : 2;
+    float sum = 0.0f, maxValue = -9999.0f;
+    for (int i = 0; i < emptyCount; i++) {
+        if (i == reply) continue;
+
+        float value;
+        if (ownWins[i]) value = gamma * win;
+        else if (emptyCount == 2) value = gamma * draw;
+        else value = agent->valueOf(afterReply + ownDigit * weights[cells[i]]);
+
+        maxValue = std::max(maxValue, value);
+        sum += value;
+    }
+
+    float expRate = agent->getExplorationRate();
+    return (1.0f - expRate) * maxValue + expRate * sum / (float) (emptyCount - 1);
+}
@@ -0,0 +1,47 @@
+#ifndef TICTACTOEAI_SWEEPER_H
+#define TICTACTOEAI_SWEEPER_H
+
+#include <utility>
+#include "Agent.h"
+
+class Sweeper {
+private:
+    Agent *agent;
+    const Agent *opponent;
+    Board board;
+    float win;
+    float loss;
+    float draw;
+    size_t capacity;
+    std::vector<uint64_t> weights;
+    std::vector<std::pair<float, uint64_t>> heap;
+    ValueTable queued;
+    std::vector<pos> replies;
+    std::vector<int> cells;
+    std::vector<char> ownWins;
+    std::vector<uint64_t> parents;
+
+    void push(uint64_t, float);
+
+    void trim();
+
+    float reward(int) const;
+
+    float target(uint64_t);
+
+    float bestValue(uint64_t, int, int);
+
+public:
+    long backups;
+
+    Sweeper(Agent *, const Agent *, int, int, float, float, float, size_t);
+
+    void changed(uint64_t, float);
+
+    int sweep(int);
+
+    size_t pending() const;
+};
+
+
+#endif //TICTACTOEAI_SWEEPER_H
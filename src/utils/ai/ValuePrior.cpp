@@ -0,0 +1,100 @@
+#include <iostream>
+#include "ValuePrior.h"
+
+/**
+ * Initial values for the states of a board, taken from an
+ * agent trained on a smaller board: the value of a state is
+ * the mean value that the small agent gives to the windows of
+ * the state that it knows. Lines are not mapped on their own:
+ * every line of up to the small board size lies inside a window.
+ * @param fileName name of a two-sided AI file, or the name given
+ * to train, for the ai1_ and ai2_ files
+ * @param l Size of the board of the states
+ */
+ValuePrior::ValuePrior(const std::string &fileName, int l) : smallBoard(readBoard(fileName)) {
+    this->l = l;
+    if (smallBoard.l > l) {
+        std::cout << "The warm-start AI board is bigger than the new one" << std::endl;
+        exit(300);
+    }
+
+    smallX.reset(new Agent(&smallBoard));
+    FILE *f = fopen(fileName.c_str(), "r");
+    if (f != nullptr) {
+        fclose(f);
+        smallX->load(fileName);
+    }
+
+    if (f == nullptr || !smallX->isTwoSided()) {
+        smallO.reset(new Agent(&smallBoard));
+        smallX->load(std::string("ai1_").append(fileName));
+        smallO->load(std::string("ai2_").append(fileName));
+    }
+
+    smallWeights = std::vector<uint64_t>(smallBoard.cellsCount);
+    uint64_t weight = 1;
+    for (uint64_t &w: smallWeights) {
+        w = weight;
+        weight *= 3;
+    }
+}
+
+/**
+ * Estimate the value of a state
+ * @param key state key on the big board
+ * @param tag tag of the agent that reached the state
+ * @return the mean value of the known windows, or 0
+ */
+float ValuePrior::estimate(uint64_t key, char tag) const {
+    const Agent *small = smallO && tag == Board::O ? smallO.get() : smallX.get();
+
+    int digits[Board::MAX_CELLS];
+    for (int i = 0; i < l * l; i++) {
+        digits[i] = (int) (key % 3);
+        key /= 3;
+    }
+
+    const int s = smallBoard.l;
+    float sum = 0.0f;
+    int found = 0;
+    for (int oy = 0; oy <= l - s; oy++) {
+        for (int ox = 0; ox <= l - s; ox++) {
+            uint64_t smallKey = 0;
+            for (int y = 0; y < s; y++)
+                for (int x = 0; x < s; x++)
+                    smallKey += digits[(oy + y) * l + ox + x] * smallWeights[y * s + x];
+
+            const float *value = small->values().find(smallKey);
+            if (value != nullptr) {
+                sum += *value;
+                found++;
+            }
+        }
+    }
+
+    return found > 0 ? sum / (float) found : 0.0f;
+}
+
+/**
+ * Create a board with the size of an AI file
+ * @param fileName name of a two-sided AI file, or the name given
+ * to train, for the ai1_ and ai2_ files
+ * @return the board
+ */
+Board ValuePrior::readBoard(const std::string &fileName) {
+    FILE *f = fopen(fileName.c_str(), "r");
+    if (f == nullptr) f = fopen(std::string("ai1_").append(fileName).c_str(), "r");
+    if (f == nullptr) {
+        std::cout << "The file does not exist" << std::endl;
+        exit(200);
+    }
+
+    int l = 0, winStr = 0;
+    if (fscanf(f, "%d\n%d\n", &l, &winStr) != 2 || l * l > Board::MAX_CELLS) {
+        std::cout << "Not a valid AI file" << std::endl;
+        exit(200);
+    }
+    fclose(f);
+
+    return Board(l, winStr);
+}
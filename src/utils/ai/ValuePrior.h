@@ -0,0 +1,24 @@
+#ifndef TICTACTOEAI_VALUEPRIOR_H
+#define TICTACTOEAI_VALUEPRIOR_H
+
+#include <memory>
+#include "Agent.h"
+
+class ValuePrior {
+private:
+    Board smallBoard;
+    std::unique_ptr<Agent> smallX;
+    std::unique_ptr<Agent> smallO;
+    int l;
+    std::vector<uint64_t> smallWeights;
+
+    static Board readBoard(const std::string &);
+
+public:
+    ValuePrior(const std::string &, int);
+
+    float estimate(uint64_t, char) const;
+};
+
+
+#endif //TICTACTOEAI_VALUEPRIOR_H
@@ -0,0 +1,256 @@
+#include <algorithm>
+#include <atomic>
+#include "ValueTable.h"
+
+#define VALUE_TABLE_MIN_CAPACITY 1024
+#define VALUE_TABLE_CHUNK_BITS 12    // 4096 slots, 64KB per chunk
+#define VALUE_TABLE_CHUNK_MASK ((1 << VALUE_TABLE_CHUNK_BITS) - 1)
+
+/**
+ * Open addressing hash table from state keys to values. The
+ * slots are a flat array split in fixed size chunks, so the
+ * slot of a key can be prefetched before it is needed.
+ *
+ * Chunks are shared between copies of a table and a chunk is
+ * cloned only when it is written while shared: a copy is a
+ * consistent snapshot that costs one pointer per chunk, and it
+ * can be read by another thread while the original keeps
+ * learning, as long as the copy is made by the writing thread.
+ */
+ValueTable::ValueTable() {
+    clear();
+}
+
+/**
+ * Make a snapshot of a table
+ * @param other the table to copy
+ */
+ValueTable::ValueTable(const ValueTable &other) {
+    *this = other;
+}
+
+/**
+ * Make a snapshot of a table
+ * @param other the table to copy
+ * @return this table
+ */
+ValueTable &ValueTable::operator=(const ValueTable &other) {
+    if (this == &other) return *this;
+
+    chunks = other.chunks;
+    refs = other.refs;
+    mask = other.mask;
+    count = other.count;
+    disown();
+    other.disown();
+    return *this;
+}
+
+/**
+ * Mark every chunk as possibly shared, so that the next write
+ * to each of them checks if it has to be cloned
+ */
+void ValueTable::disown() const {
+    for (ChunkRef &ref: refs) ref.owned = false;
+}
+
+/**
+ * Slot where the search for a key starts
+ * @param key state key
+ * @return index of the slot
+ */
+size_t ValueTable::indexOf(uint64_t key) const {
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    return (size_t) key & mask;
+}
+
+/**
+ * Find the slot of a state
+ * @param key state key
+ * @return index of the slot of the state, or of the empty
+ * slot where it would be added
+ */
+size_t ValueTable::probe(uint64_t key) const {
+    size_t i = indexOf(key);
+    const Slot *chunk = refs[i >> VALUE_TABLE_CHUNK_BITS].slots;
+    while (chunk[i & VALUE_TABLE_CHUNK_MASK].key != key && chunk[i & VALUE_TABLE_CHUNK_MASK].key != EMPTY) {
+        i = (i + 1) & mask;
+        if ((i & VALUE_TABLE_CHUNK_MASK) == 0) chunk = refs[i >> VALUE_TABLE_CHUNK_BITS].slots;
+    }
+    return i;
+}
+
+/**
+ * @param i index of a slot
+ * @return the slot, for reading
+ */
+const ValueTable::Slot &ValueTable::at(size_t i) const {
+    return refs[i >> VALUE_TABLE_CHUNK_BITS].slots[i & VALUE_TABLE_CHUNK_MASK];
+}
+
+/**
+ * Get a slot for writing, cloning its chunk first if it is
+ * still shared with a snapshot
+ * @param i index of a slot
+ * @return the slot
+ */
+ValueTable::Slot &ValueTable::writable(size_t i) {
+    ChunkRef &ref = refs[i >> VALUE_TABLE_CHUNK_BITS];
+    if (!ref.owned) {
+        std::shared_ptr<Chunk> &chunk = chunks[i >> VALUE_TABLE_CHUNK_BITS];
+        if (chunk.use_count() != 1) {
+            chunk = std::make_shared<Chunk>(*chunk);
+            ref.slots = chunk->data();
+        } else {
+            // The last reader released the chunk, its reads must come before our writes
+            std::atomic_thread_fence(std::memory_order_acquire);
+        }
+        ref.owned = true;
+    }
+    return ref.slots[i & VALUE_TABLE_CHUNK_MASK];
+}
+
+/**
+ * Find the value of a state
+ * @param key state key
+ * @return pointer to the value, or nullptr if the state is unknown
+ */
+float *ValueTable::find(uint64_t key) {
+    size_t i = probe(key);
+    return at(i).key == key ? &writable(i).value : nullptr;
+}
+
+/**
+ * Find the value of a state
+ * @param key state key
+ * @return pointer to the value, or nullptr if the state is unknown
+ */
+const float *ValueTable::find(uint64_t key) const {
+    const Slot &slot = at(probe(key));
+    return slot.key == key ? &slot.value : nullptr;
+}
+
+/**
+ * Find the value of a state, adding it if it is unknown
+ * @param key state key
+ * @param initialValue value of the state if it is added
+ * @param inserted set to true if the state was added
+ * @return pointer to the value, valid until the next insertion
+ */
+float *ValueTable::findOrInsert(uint64_t key, float initialValue, bool &inserted) {
+    if ((count + 1) * 10 > capacity() * 7) grow();
+
+    size_t i = probe(key);
+    Slot &slot = writable(i);
+    if (slot.key == key) {
+        inserted = false;
+        return &slot.value;
+    }
+
+    slot.key = key;
+    slot.value = initialValue;
+    count++;
+    inserted = true;
+    return &slot.value;
+}
+
+/**
+ * Ask the CPU to start loading the slot of a state
+ * @param key state key
+ */
+void ValueTable::prefetch(uint64_t key) const {
+    __builtin_prefetch(&at(indexOf(key)));
+}
+
+/**
+ * Remove a state
+ * @param key state key
+ * @return true if the state was known
+ */
+bool ValueTable::erase(uint64_t key) {
+    size_t i = probe(key);
+    if (at(i).key != key) return false;
+
+    // Shift back the following entries that would not be found anymore
+    for (size_t j = (i + 1) & mask; at(j).key != EMPTY; j = (j + 1) & mask) {
+        size_t home = indexOf(at(j).key);
+        bool reachable = i <= j ? (i < home && home <= j) : (i < home || home <= j);
+        if (reachable) continue;
+
+        writable(i) = at(j);
+        i = j;
+    }
+
+    writable(i).key = EMPTY;
+    count--;
+    return true;
+}
+
+/**
+ * Double the slots and move every entry
+ */
+void ValueTable::grow() {
+    rehash(capacity() * 2);
+}
+
+/**
+ * Move every entry to a new array of slots
+ * @param newCapacity number of slots, a power of two
+ */
+void ValueTable::rehash(size_t newCapacity) {
+    std::vector<std::shared_ptr<Chunk>> old;
+    old.swap(chunks);
+
+    // New chunks are never shared, so the slots can be written directly
+    size_t chunkSize = std::min(newCapacity, (size_t) VALUE_TABLE_CHUNK_MASK + 1);
+    refs.clear();
+    for (size_t i = 0; i < newCapacity; i += chunkSize) {
+        chunks.push_back(std::make_shared<Chunk>(chunkSize, Slot{EMPTY, 0.0f}));
+        refs.push_back(ChunkRef{chunks.back()->data(), true});
+    }
+    mask = newCapacity - 1;
+
+    for (const std::shared_ptr<Chunk> &chunk: old) {
+        for (const Slot &slot: *chunk) {
+            if (slot.key == EMPTY) continue;
+
+            size_t i = indexOf(slot.key);
+            while (at(i).key != EMPTY) i = (i + 1) & mask;
+            refs[i >> VALUE_TABLE_CHUNK_BITS].slots[i & VALUE_TABLE_CHUNK_MASK] = slot;
+        }
+    }
+}
+
+/**
+ * Release the slots that are not needed by the current entries
+ */
+void ValueTable::shrinkToFit() {
+    size_t newCapacity = VALUE_TABLE_MIN_CAPACITY;
+    while ((count + 1) * 10 > newCapacity * 7) newCapacity *= 2;
+    if (newCapacity < capacity()) rehash(newCapacity);
+}
+
+/**
+ * @return number of known states
+ */
+size_t ValueTable::size() const {
+    return count;
+}
+
+/**
+ * @return number of slots
+ */
+size_t ValueTable::capacity() const {
+    return mask + 1;
+}
+
+/**
+ * Remove every state
+ */
+void ValueTable::clear() {
+    chunks.clear();
+    count = 0;
+    rehash(VALUE_TABLE_MIN_CAPACITY);
+}
@@ -0,0 +1,78 @@
+#ifndef TICTACTOEAI_VALUETABLE_H
+#define TICTACTOEAI_VALUETABLE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+class ValueTable {
+private:
+    struct Slot {
+        uint64_t key;
+        float value;
+    };
+
+    typedef std::vector<Slot> Chunk;
+
+    struct ChunkRef {
+        Slot *slots;
+        bool owned;     // known to be not shared, no need to check the reference count
+    };
+
+    std::vector<std::shared_ptr<Chunk>> chunks;
+    mutable std::vector<ChunkRef> refs;
+    size_t mask;
+    size_t count;
+
+    size_t indexOf(uint64_t) const;
+
+    size_t probe(uint64_t) const;
+
+    const Slot &at(size_t) const;
+
+    Slot &writable(size_t);
+
+    void disown() const;
+
+    void grow();
+
+    void rehash(size_t);
+
+public:
+    static const uint64_t EMPTY = UINT64_MAX;
+
+    ValueTable();
+
+    ValueTable(const ValueTable &);
+
+    ValueTable &operator=(const ValueTable &);
+
+    float *find(uint64_t);
+
+    const float *find(uint64_t) const;
+
+    float *findOrInsert(uint64_t, float, bool &);
+
+    bool erase(uint64_t);
+
+    void prefetch(uint64_t) const;
+
+    size_t size() const;
+
+    size_t capacity() const;
+
+    void clear();
+
+    void shrinkToFit();
+
+    template<typename F>
+    void forEach(F f) const {
+        for (const std::shared_ptr<Chunk> &chunk: chunks)
+            for (const Slot &slot: *chunk)
+                if (slot.key != EMPTY) f(slot.key, slot.value);
+    }
+};
+
+
+#endif //TICTACTOEAI_VALUETABLE_H
@@ -1,5 +1,34 @@
 #include "Board.h"
 
+const char Board::X;
+const char Board::O;
+const char Board::NONE;
+const char Board::BOTH;
+const int Board::MAX_CELLS;
+
+/**
+ * Weight of each cell in a state key: the board is read
+ * as a base 3 number where NONE, X and O are 0, 1 and 2
+ */
+static const std::vector<uint64_t> CELL_WEIGHTS = []() {
+    std::vector<uint64_t> weights(Board::MAX_CELLS);
+    uint64_t weight = 1;
+    for (int i = 0; i < Board::MAX_CELLS; i++) {
+        weights[i] = weight;
+        weight *= 3;
+    }
+    return weights;
+}();
+
+/**
+ * Digit of a tag in a state key
+ * @param tag the tag
+ * @return 0 for NONE, 1 for X, 2 for O
+ */
+static inline uint64_t tagDigit(char tag) {
+    return tag == Board::X ? 1 : (tag == Board::O ? 2 : 0);
+}
+
 /**
  * Create a new board
  * @param l Size of the board
@@ -11,118 +40,64 @@ Board::Board(int l, int winStr) {
     this->winStr = winStr;
     this->movesCount = 0;
 
-    boardData = new char *[l];
-    for (int i = 0; i < l; i++) {
-        boardData[i] = new char[l];
-    }
+    boardData = std::vector<std::vector<char>>(l, std::vector<char>(l, NONE));
 
     turn = X;
 
-    std::random_device rndDevice;
-    this->rndEngine = std::mt19937(rndDevice());
-    this->rndFloatGenerator = std::uniform_real_distribution<float>(0.0f, 1.0f);
-    this->rndIntGenerator = std::uniform_int_distribution<int>(0, 32767);
+    this->rng.seed(Rng::randomSeed());
+    this->unitFloatsUsed = BOARD_RANDOM_BLOCK;
 
     this->reset();
 }
 
+/**
+ * Seed the random generator of the board, to make the
+ * games reproducible
+ * @param seed The seed of the generator
+ * @param stream The index of the independent stream
+ */
+void Board::seed(uint64_t seed, uint64_t stream) {
+    rng.seed(seed, stream);
+    unitFloatsUsed = BOARD_RANDOM_BLOCK;
+}
+
 /**
  * Get the state of the game
  * @return 0 for normal, 1 for X victory, 2 for
  * O victory, 3 for draw
  */
 int Board::getGameStatus() {
-    // Cerca vittorie orizzontali
-    for (int y = 0; y < l; y++) {
-        int xs = 0, os = 0;
-        for (int x = 0; x < l; x++) {
-            if (boardData[y][x] == X) xs++;
-            else xs = 0;
-            if (xs >= winStr) return 1;
-
-            if (boardData[y][x] == O) os++;
-            else os = 0;
-            if (os >= winStr) return 2;
-        }
-    }
-
-    // Cerca vittorie verticali
-    for (int x = 0; x < l; x++) {
-        int xs = 0, os = 0;
-        for (int y = 0; y < l; y++) {
-            if (boardData[y][x] == X) xs++;
-            else xs = 0;
-            if (xs >= winStr) return 1;
-
-            if (boardData[y][x] == O) os++;
-            else os = 0;
-            if (os >= winStr) return 2;
-        }
-    }
-
-    // Cerca vittorie diagonali avanti inferiori + centrale
-    for (int y = 0; y < l; y++) {
-        int tx = 0, xs = 0, os = 0;
-        for (int ty = y; ty < l; ty++) {
-            if (boardData[ty][tx] == X) xs++;
-            else xs = 0;
-            if (xs >= winStr) return 1;
-
-            if (boardData[ty][tx] == O) os++;
-            else os = 0;
-            if (os >= winStr) return 2;
-            tx++;
-        }
-    }
-
-    // Cerca vittorie diagonali avanti superiori
-    for (int y = 1; y < l; y++) {
-        int tx = 0, xs = 0, os = 0;
-        for (int ty = y; ty < l; ty++) {
-            if (boardData[tx][ty] == X) xs++;
-            else xs = 0;
-            if (xs >= winStr) return 1;
-
-            if (boardData[tx][ty] == O) os++;
-            else os = 0;
-            if (os >= winStr) return 2;
-            tx++;
-        }
-    }
+    if (winStatus != 0) return winStatus;
+    if (movesCount >= cellsCount) return 3;
 
-    // Cerca vittorie diagonali indietro inferiori + centrale
-    for (int x = l - 1; x >= 0; x--) {
-        int tx = x, xs = 0, os = 0;
-        for (int ty = 0; ty <= x; ty++) {
-            if (boardData[tx][ty] == X) xs++;
-            else xs = 0;
-            if (xs >= winStr) return 1;
-
-            if (boardData[tx][ty] == O) os++;
-            else os = 0;
-            if (os >= winStr) return 2;
-            tx--;
-        }
-    }
+    return 0;
+}
 
-    // Cerca vittorie diagonali indietro superiori
-    for (int y = 1; y < l; y++) {
-        int ty = y, xs = 0, os = 0;
-        for (int x = l - 1; x >= y; x--) {
-            if (boardData[ty][x] == X) xs++;
-            else xs = 0;
-            if (xs >= winStr) return 1;
-
-            if (boardData[ty][x] == O) os++;
-            else os = 0;
-            if (os >= winStr) return 2;
-            ty++;
+/**
+ * Check if an action completed a streak, or would complete
+ * it if the cell is still empty. Only the four lines that
+ * pass through the action can contain a new one.
+ * @param tag tag of who performed the action
+ * @param p position of the action
+ * @return true if the action won the game
+ */
+bool Board::isWinningAction(char tag, pos p) {
+    static const int DIRS[4][2] = {{1, 0}, {0, 1}, {1, 1}, {1, -1}};
+
+    for (const int *dir: DIRS) {
+        int streak = 1;
+        for (int sign = -1; sign <= 1; sign += 2) {
+            int x = p.x + sign * dir[0], y = p.y + sign * dir[1];
+            while (x >= 0 && x < l && y >= 0 && y < l && boardData[y][x] == tag) {
+                streak++;
+                x += sign * dir[0];
+                y += sign * dir[1];
+            }
         }
+        if (streak >= winStr) return true;
     }
 
-    if (movesCount >= cellsCount) return 3;
-
-    return 0;
+    return false;
 }
 
 /**
@@ -134,6 +109,8 @@ int Board::getGameStatus() {
 int Board::performAction(char tag, pos p) {
     if ((p.x >= 0 && p.x < l && p.y >= 0 && p.y < l) && (boardData[p.y][p.x] == NONE)) {
         boardData[p.y][p.x] = tag;
+        stateKey += tagDigit(tag) * CELL_WEIGHTS[p.y * l + p.x];
+        if (winStatus == 0 && isWinningAction(tag, p)) winStatus = tag == X ? 1 : 2;
         nextTurn();
     } else return 0;
 
@@ -160,6 +137,51 @@ int Board::getAvailableActions(pos *validActions) {
     return actionsCount;
 }
 
+/**
+ * @return the number of actions performed since the last reset
+ */
+int Board::getMovesCount() const {
+    return movesCount;
+}
+
+/**
+ * Put the board in a given state, as if it was reached
+ * by playing its moves
+ * @param key state key
+ */
+void Board::setState(uint64_t key) {
+    reset();
+
+    std::string hash = keyToHash(key);
+    int xs = 0, os = 0;
+    for (int i = 0; i < cellsCount; i++) {
+        boardData[i / l][i % l] = hash[i];
+        if (hash[i] == X) xs++;
+        else if (hash[i] == O) os++;
+    }
+
+    stateKey = key;
+    movesCount = xs + os;
+    turn = xs > os ? O : X;
+    if (hasStreak(X)) winStatus = 1;
+    else if (hasStreak(O)) winStatus = 2;
+}
+
+/**
+ * Check the whole board for a streak
+ * @param tag tag of the streak
+ * @return true if tag has at least winStr consecutive symbols
+ */
+bool Board::hasStreak(char tag) {
+    for (int y = 0; y < l; y++)
+        for (int x = 0; x < l; x++) {
+            pos p = {(unsigned short) x, (unsigned short) y};
+            if (boardData[y][x] == tag && isWinningAction(tag, p)) return true;
+        }
+
+    return false;
+}
+
 /**
  * Print the board with coordinates
  */
@@ -187,40 +209,56 @@ void Board::nextTurn() {
 }
 
 /**
- * Flattens the board matrix to a string.
- * @return string that identifies the current state.
+ * Key that identifies the current state.
+ * @return the board as a base 3 number.
  */
-std::string Board::getStateHash() {
-    std::string hash;
-    int y = 0;
-    for (int i = 0; i < cellsCount; i++) {
-        hash += boardData[y][i % l];
-        if (i % l == l - 1) y++;
-    }
-
-    return hash;
+uint64_t Board::getStateKey() const {
+    return stateKey;
 }
 
 /**
- * Flattens the board matrix to a string after performing
- * the action.
+ * Key that identifies the state after performing the action.
  * @param tag tag of who performs the action
  * @param p position of the action
- * @return string that identifies the future state.
+ * @return the future board as a base 3 number.
+ */
+uint64_t Board::getStateKey(char tag, pos p) const {
+    return stateKey + tagDigit(tag) * CELL_WEIGHTS[p.y * l + p.x];
+}
+
+/**
+ * Flattens a state key to a string, one character per cell.
+ * @param key state key
+ * @return string that identifies the state.
  */
-std::string Board::getStateHash(char tag, pos p) {
-    std::string hash;
-    int y = 0, x;
+std::string Board::keyToHash(uint64_t key) const {
+    std::string hash(cellsCount, NONE);
     for (int i = 0; i < cellsCount; i++) {
-        x = i % l;
+        int digit = (int) (key % 3);
+        if (digit == 1) hash[i] = X;
+        else if (digit == 2) hash[i] = O;
+        key /= 3;
+    }
 
-        if (x == p.x && y == p.y) hash += tag;
-        else hash += (boardData[y][x]);
+    return hash;
+}
 
-        if (i % l == l - 1) y++;
+/**
+ * Convert a string made by keyToHash back to a state key.
+ * @param hash string that identifies the state
+ * @return the state key, or UINT64_MAX if the string is not valid
+ */
+uint64_t Board::hashToKey(const std::string &hash) const {
+    if ((int) hash.size() < cellsCount) return UINT64_MAX;
+
+    uint64_t key = 0;
+    for (int i = 0; i < cellsCount; i++) {
+        if (hash[i] == X) key += CELL_WEIGHTS[i];
+        else if (hash[i] == O) key += 2 * CELL_WEIGHTS[i];
+        else if (hash[i] != NONE) return UINT64_MAX;
     }
 
-    return hash;
+    return key;
 }
 
 /**
@@ -247,16 +285,23 @@ void Board::printPos(pos p) {
  */
 void Board::reset() {
     movesCount = 0;
+    stateKey = 0;
+    winStatus = 0;
     turn = X;
     clearBoard();
 }
 
 /**
- * Generate random float between 0.0 and 1.0 excluded.
- * @return random float between 0.0 and 1.1 excluded
+ * Generate random float between 0.0 and 1.0 excluded. The
+ * floats are generated in blocks, one is taken per call.
+ * @return random float between 0.0 and 1.0 excluded
  */
 float Board::randomUnitFloat() {
-    return rndFloatGenerator(rndEngine);
+    if (unitFloatsUsed == BOARD_RANDOM_BLOCK) {
+        rng.fillFloats(unitFloats, BOARD_RANDOM_BLOCK);
+        unitFloatsUsed = 0;
+    }
+    return unitFloats[unitFloatsUsed++];
 }
 
 /**
@@ -265,5 +310,5 @@ float Board::randomUnitFloat() {
  * @return random int between 0 and max excluded
  */
 int Board::randomInt(int max) {
-    return rndIntGenerator(rndEngine) % max;
+    return (int) rng.nextInt(max);
 }
\ No newline at end of file
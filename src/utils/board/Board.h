@@ -1,7 +1,11 @@
 #ifndef TICTACTOEAI_BOARD_H
 #define TICTACTOEAI_BOARD_H
 
-#include <random>
+#include <string>
+#include <vector>
+#include "../random/Rng.h"
+
+#define BOARD_RANDOM_BLOCK 32   // unit floats generated at once for the exploration choices
 
 typedef struct {
     unsigned short int x;
@@ -10,11 +14,13 @@ typedef struct {
 
 class Board {
 private:
-    char **boardData;
+    std::vector<std::vector<char>> boardData;
     int movesCount;
-    std::uniform_real_distribution<float> rndFloatGenerator;
-    std::uniform_int_distribution<int> rndIntGenerator;
-    std::mt19937 rndEngine;
+    uint64_t stateKey;
+    int winStatus;
+    Rng rng;
+    float unitFloats[BOARD_RANDOM_BLOCK];
+    int unitFloatsUsed;
 
     void nextTurn();
 
@@ -24,6 +30,8 @@ public:
     static const char X = 'X';
     static const char O = 'O';
     static const char NONE = '.';
+    static const char BOTH = '*';
+    static const int MAX_CELLS = 40;
     int l;
     int winStr;
     char turn;
@@ -31,20 +39,34 @@ public:
 
     Board(int, int);
 
+    void seed(uint64_t, uint64_t = 0);
+
     void reset();
 
     void print();
 
     int performAction(char, pos);
 
+    bool isWinningAction(char, pos);
+
     int getGameStatus();
 
-    std::string getStateHash();
+    uint64_t getStateKey() const;
+
+    uint64_t getStateKey(char tag, pos p) const;
 
-    std::string getStateHash(char tag, pos p);
+    std::string keyToHash(uint64_t) const;
+
+    uint64_t hashToKey(const std::string &) const;
 
     int getAvailableActions(pos *);
 
+    int getMovesCount() const;
+
+    void setState(uint64_t);
+
+    bool hasStreak(char);
+
     static void printPos(pos);
 
     float randomUnitFloat();
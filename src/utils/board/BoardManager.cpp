@@ -1,22 +1,71 @@
 #include <iostream>
 #include <thread>
+#include <chrono>
+#include <cmath>
+#include <algorithm>
 #include "BoardManager.h"
+#include "../episodes/EpisodeLog.h"
+#include "../ai/AgentAnalyzer.h"
+#include "../ai/Ponderer.h"
+#include "../ai/ValuePrior.h"
+#include "../ai/Sweeper.h"
+#include "PopulationTrainer.h"
+#include "LiveEvaluator.h"
 
 #define BENCH_ITERS 100000
 
+#define SELF_PLAY_PREFETCH_AHEAD 4  // lockstep games whose candidates are loading at the same time
+
+// Convergence tracking used by train when early stopping is enabled
+#define CONV_BATCH 100000           // games between two convergence checks
+#define CONV_EVAL_GAMES 2000        // games per agent of a quick evaluation
+#define CONV_MAX_DELTA_CHANGE 0.05  // relative change of the mean absolute value update
+#define CONV_MAX_DISCOVERY 1e-3     // fraction of updates that found a new state
+#define CONV_MAX_LOSS_CHANGE 0.01   // change of the loss rate against a random player
+#define CONV_PATIENCE 3             // consecutive converged evaluations needed
+#define CONV_MIN_EXP_RATE 0.05      // exploration rate below which training stops
+
+#define LIVE_EVAL_GAMES 10000       // games per agent of an evaluation during training
+#define SWEEP_QUEUE_CAPACITY 100000 // states queued by each agent for prioritized sweeping
+
 BoardManager::BoardManager() = default;
 
+/**
+ * Make every game played by this manager reproducible
+ * @param _seed The seed from which all the random streams are derived
+ */
+void BoardManager::setSeed(uint64_t _seed) {
+    this->seeded = true;
+    this->seed = _seed;
+    applySeed(board);
+}
+
 /**
  * Train two agents
  * @param l The size of the board
  * @param winStr The number of consecutive symbols needed to win
- * @param iterations The number of games that the agents will play
+ * @param iterations The maximum number of games that the agents will play
+ * @param earlyStop If true, the exploration rate is decayed and the
+ * training stops as soon as the agents converge
+ * @param parallelGames The number of games played in lockstep
+ * @param shared If true, both agents learn in a single table
+ * saved as one two-sided file
+ * @param liveEvery The number of games between two evaluations of
+ * snapshots of the agents on a background thread, 0 for none
+ * @param sweepBackups The number of prioritized sweeping updates of
+ * each agent after every game, 0 for none
+ * @param lambda The trace decay of the TD(lambda) updates, negative
+ * for the classic update
  */
-void BoardManager::train(int l, int winStr, int iterations) {
+void BoardManager::train(int l, int winStr, int iterations, bool earlyStop, int parallelGames, bool shared,
+                         int liveEvery, int sweepBackups, float lambda) {
     makeBoard(l, winStr);
 
     Agent ai1 = Agent(&board, Board::X);
     Agent ai2 = Agent(&board, Board::O);
+    if (shared) ai2.shareValues(ai1);
+    ai1.setTraceDecay(lambda);
+    ai2.setTraceDecay(lambda);
 
     if (ai1.tag == ai2.tag) {
         std::cout << "Incompatible AIs: same tags" << std::endl;
@@ -28,42 +77,248 @@ void BoardManager::train(int l, int winStr, int iterations) {
     fflush(stdin);
     std::getline(std::cin, fileName);
 
-    pos action;
-    int status;
-    for (int game = 0; game < iterations; game++) {
+    std::string logFileName;
+    std::cout << "Episode log file (empty for none): ";
+    std::getline(std::cin, logFileName);
+    EpisodeWriter *log = logFileName.empty() ? nullptr : new EpisodeWriter(logFileName, l, winStr);
+
+    std::string priorFileName;
+    std::cout << "Warm-start from a smaller board AI file (empty for none): ";
+    std::getline(std::cin, priorFileName);
+    std::unique_ptr<ValuePrior> prior(priorFileName.empty() ? nullptr : new ValuePrior(priorFileName, l));
+    ai1.setPrior(prior.get());
+    ai2.setPrior(prior.get());
+
+    std::unique_ptr<LiveEvaluator> live;
+    if (liveEvery > 0) live.reset(new LiveEvaluator(l, winStr, LIVE_EVAL_GAMES, seeded, Rng(seed)()));
+
+    std::unique_ptr<Sweeper> sweeper1, sweeper2;
+    if (sweepBackups > 0) {
+        sweeper1.reset(new Sweeper(&ai1, &ai2, l, winStr, gameRewards.win, gameRewards.loss, gameRewards.draw,
+                                   SWEEP_QUEUE_CAPACITY));
+        sweeper2.reset(new Sweeper(&ai2, &ai1, l, winStr, gameRewards.win, gameRewards.loss, gameRewards.draw,
+                                   SWEEP_QUEUE_CAPACITY));
+        ai1.setSweeper(sweeper1.get());
+        ai2.setSweeper(sweeper2.get());
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    int patience = 0;
+    double lastDelta = -1.0;
+    float lastLossX = 0.0f, lastLossO = 0.0f;
+    int game = selfPlay(ai1, ai2, iterations, parallelGames, [&](int game, const int *moves, int movesCount,
+                                                                 int status) {
         if (game % 100000 == 0) printf("Iteration: %dk\n", game / 1000);
-        board.reset();
+        if (log) log->writeGame(moves, movesCount, status);
+        if (live && game % liveEvery == 0) live->submit(ai1, ai2, game);
+        if (sweepBackups > 0) {
+            sweeper1->sweep(sweepBackups);
+            sweeper2->sweep(sweepBackups);
+        }
+
+        if (!earlyStop || game % CONV_BATCH != 0) return true;
+
+        double delta1, delta2, discovery1, discovery2;
+        ai1.takeLearningStats(delta1, discovery1);
+        ai2.takeLearningStats(delta2, discovery2);
+        float lossX = (float) playVsRandom(ai1, CONV_EVAL_GAMES) / CONV_EVAL_GAMES;
+        float lossO = (float) playVsRandom(ai2, CONV_EVAL_GAMES) / CONV_EVAL_GAMES;
+        double delta = std::max(delta1, delta2);
+        double discovery = std::max(discovery1, discovery2);
+        printf("[%dk] delta: %.2e, new states: %.2e, X loss: %.2f%%, O loss: %.2f%%\n", game / 1000,
+               delta, discovery, lossX * 100.0f, lossO * 100.0f);
+
+        // With a constant learning rate the updates never vanish, they
+        // settle to the noise of the rewards instead
+        bool converged = lastDelta > 0.0 && std::fabs(delta - lastDelta) < CONV_MAX_DELTA_CHANGE * lastDelta &&
+                         discovery < CONV_MAX_DISCOVERY &&
+                         std::fabs(lossX - lastLossX) < CONV_MAX_LOSS_CHANGE &&
+                         std::fabs(lossO - lastLossO) < CONV_MAX_LOSS_CHANGE;
+        lastDelta = delta;
+        lastLossX = lossX;
+        lastLossO = lossO;
+        patience = converged ? patience + 1 : 0;
+        if (patience < CONV_PATIENCE) return true;
+
+        patience = 0;
+        float expRate = ai1.getExplorationRate() * 0.5f;
+        if (expRate < CONV_MIN_EXP_RATE) {
+            printf("Converged after %d games.\n", game);
+            return false;
+        }
+        printf("Converged, exploration rate decayed to %.4f\n", expRate);
+        ai1.setExplorationRate(expRate);
+        ai2.setExplorationRate(expRate);
+        return true;
+    });
+
+    if (log) {
+        printf("Logged %ld games to %s\n", log->gamesCount, logFileName.c_str());
+        delete log;
+    }
 
-        do {
-            if (board.turn == ai1.tag) {
-                action = ai1.chooseAction();
-                board.performAction(board.turn, action);
-                ai1.addGameState(board.getStateHash());
-            } else {
-                action = ai2.chooseAction();
-                board.performAction(board.turn, action);
-                ai2.addGameState(board.getStateHash());
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Training finished.\n";
+    printf("Played %d games in %.1fs (%.0f games/s)\n", game, seconds, game / seconds);
+    if (sweepBackups > 0) {
+        printf("Prioritized sweeping: %ld backups, %lu states still queued\n",
+               sweeper1->backups + sweeper2->backups, sweeper1->pending() + sweeper2->pending());
+        ai1.setSweeper(nullptr);
+        ai2.setSweeper(nullptr);
+    }
+    if (live) live->finish();
+    if (prior) {
+        ai1.keepPriorValues();
+        ai2.keepPriorValues();
+    }
+    saveAgents(ai1, ai2, fileName);
+}
+
+/**
+ * Train a population of agent pairs with different
+ * hyperparameters and keep the best pair
+ * @param l The size of the board
+ * @param winStr The number of consecutive symbols needed to win
+ * @param populationSize The number of agent pairs
+ * @param rounds The number of train, evaluate and replace rounds
+ * @param gamesPerRound The number of games played by each pair per round
+ */
+void BoardManager::populationTrain(int l, int winStr, int populationSize, int rounds, int gamesPerRound) {
+    makeBoard(l, winStr);
+
+    std::string fileName;
+    std::cout << "File name: ";
+    fflush(stdin);
+    std::getline(std::cin, fileName);
+
+    auto start = std::chrono::steady_clock::now();
+    PopulationTrainer trainer = PopulationTrainer(l, winStr, populationSize, seeded, seed);
+    trainer.run(rounds, gamesPerRound, fileName);
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    printf("Trained %d pairs for %d rounds in %.1fs\n", populationSize, rounds, seconds);
+}
+
+/**
+ * Let two agents play against each other and learn. Several
+ * independent games are advanced in lockstep: at every step the
+ * value table slots of all the candidate actions of all the games
+ * are prefetched before any of them is evaluated, and the games
+ * that ended are rewarded together, so that the table memory
+ * latency of a game is hidden behind the work on the others.
+ * @param ai1 The X agent
+ * @param ai2 The O agent
+ * @param games The number of games to play
+ * @param parallelGames The number of games played in lockstep
+ * @param onGameEnd Called after each game is rewarded with the number
+ * of played games, the moves as cell indices, the moves count and the
+ * final status; training stops if it returns false
+ * @return The number of played games
+ */
+int BoardManager::selfPlay(Agent &ai1, Agent &ai2, int games, int parallelGames,
+                           const std::function<bool(int, const int *, int, int)> &onGameEnd) {
+    const int k = std::max(parallelGames, 1);
+    const int cells = board.cellsCount;
+
+    std::vector<Board> boards;
+    boards.reserve(k);
+    std::vector<uint64_t> states(2 * k * cells);
+    std::vector<int> statesCount(2 * k, 0);
+    std::vector<int> moves(k * cells);
+    std::vector<int> statuses(k, 0);
+    std::vector<int> active, ended;
+
+    int started = 0, finished = 0;
+    for (int g = 0; g < k; g++) {
+        boards.push_back(Board(board.l, board.winStr));
+        applySeed(boards[g], nextStream++);
+        if (started < games) {
+            active.push_back(g);
+            started++;
+        }
+    }
+
+    auto prefetch = [&](int g) {
+        Agent &ai = boards[g].turn == ai1.tag ? ai1 : ai2;
+        ai.prefetchActions(boards[g]);
+    };
+
+    while (!active.empty()) {
+        // Keep the candidates of the next games loading while the current one is evaluated
+        const int n = (int) active.size();
+        if (n > 1) for (int i = 0; i < std::min(n, SELF_PLAY_PREFETCH_AHEAD); i++) prefetch(active[i]);
+
+        for (int i = 0; i < n; i++) {
+            int g = active[i];
+            if (n > 1 && i + SELF_PLAY_PREFETCH_AHEAD < n) prefetch(active[i + SELF_PLAY_PREFETCH_AHEAD]);
+
+            Board &b = boards[g];
+            int side = b.turn == ai1.tag ? 0 : 1;
+            Agent &ai = side == 0 ? ai1 : ai2;
+
+            pos action = ai.chooseAction(b);
+            moves[g * cells + b.getMovesCount()] = action.y * b.l + action.x;
+            b.performAction(b.turn, action);
+            int &count = statesCount[2 * g + side];
+            states[(2 * g + side) * cells + count++] = b.getStateKey();
+
+            statuses[g] = b.getGameStatus();
+            if (statuses[g] != 0) ended.push_back(g);
+        }
+        if (ended.empty()) continue;
+
+        for (int g: ended) {
+            ai1.prefetchStates(&states[2 * g * cells], statesCount[2 * g]);
+            ai2.prefetchStates(&states[(2 * g + 1) * cells], statesCount[2 * g + 1]);
+        }
+
+        // After a stop the other ended games are dropped, so that every
+        // game the agents learned from was also seen by onGameEnd
+        bool stop = false;
+        for (int g: ended) {
+            ai1.feedReward(reward(ai1.tag, statuses[g]), &states[2 * g * cells], statesCount[2 * g]);
+            ai2.feedReward(reward(ai2.tag, statuses[g]), &states[(2 * g + 1) * cells], statesCount[2 * g + 1]);
+
+            finished++;
+            if (!onGameEnd(finished, &moves[g * cells], boards[g].getMovesCount(), statuses[g])) {
+                stop = true;
+                break;
             }
 
-            status = board.getGameStatus();
-        } while (status == 0);
+            boards[g].reset();
+            statesCount[2 * g] = 0;
+            statesCount[2 * g + 1] = 0;
+        }
 
-        if (status == 1) {
-            ai1.feedReward(1.0);
-            ai2.feedReward(-0.5);
-        } else if (status == 2) {
-            ai1.feedReward(-0.5);
-            ai2.feedReward(1.0);
-        } else if (status == 3) {
-            ai1.feedReward(0.3);
-            ai2.feedReward(0.3);
-        } else printf("An error occurred\n");
+        if (stop) break;
 
-        ai1.newGame();
-        ai2.newGame();
+        for (int g: ended) {
+            if (started < games) started++;
+            else active.erase(std::find(active.begin(), active.end(), g));
+        }
+        ended.clear();
+    }
+
+    return finished;
+}
+
+/**
+ * Print the info of two trained agents and save them, as
+ * ai1_ and ai2_ files or as a single two-sided file
+ * @param ai1 The X agent
+ * @param ai2 The O agent
+ * @param fileName The name of the files
+ */
+void BoardManager::saveAgents(Agent &ai1, Agent &ai2, const std::string &fileName) {
+    if (ai1.isTwoSided()) {
+        std::cout << "\nAI Agent info:\n";
+        ai1.debug();
+
+        std::cout << "\nSaving AI Agent...\n";
+        ai1.save(fileName);
+        return;
     }
 
-    std::cout << "Training finished.\n";
     std::cout << "\nAI1 Agent info:\n";
     ai1.debug();
     std::cout << "\nAI2 Agent info:\n";
@@ -75,15 +330,113 @@ void BoardManager::train(int l, int winStr, int iterations) {
     ai2.save(std::string("ai2_").append(fileName));
 }
 
+/**
+ * Reward given to an agent at the end of a game
+ * @param tag The tag of the agent
+ * @param status The final status of the game
+ * @return The reward
+ */
+float BoardManager::reward(char tag, int status) const {
+    if (status == 3) return gameRewards.draw;
+    if ((status == 1 && tag == Board::X) || (status == 2 && tag == Board::O)) return gameRewards.win;
+    return gameRewards.loss;
+}
+
+/**
+ * Train two agents offline, replaying the games of an episode
+ * log written by train
+ * @param logFile The name of the episode log
+ * @param learningRate The learning rate of the agents
+ * @param decayGamma The value of future reward of the agents
+ * @param shared If true, both agents learn in a single table
+ * saved as one two-sided file
+ * @param lambda The trace decay of the TD(lambda) updates, negative
+ * for the classic update
+ */
+void BoardManager::replayTrain(const std::string &logFile, float learningRate, float decayGamma, bool shared,
+                               float lambda) {
+    EpisodeReader reader = EpisodeReader(logFile);
+    makeBoard(reader.l, reader.winStr);
+
+    Agent ai1 = Agent(&board, Board::X, 0.3, decayGamma, learningRate);
+    Agent ai2 = Agent(&board, Board::O, 0.3, decayGamma, learningRate);
+    if (shared) ai2.shareValues(ai1);
+    ai1.setTraceDecay(lambda);
+    ai2.setTraceDecay(lambda);
+
+    std::string fileName;
+    std::cout << "File name: ";
+    fflush(stdin);
+    std::getline(std::cin, fileName);
+
+    auto start = std::chrono::steady_clock::now();
+    int *moves = new int[board.cellsCount];
+    int movesCount, status;
+    long games = 0;
+    while (reader.nextBlock()) {
+        while (reader.nextGame(moves, movesCount, status)) {
+            board.reset();
+
+            for (int i = 0; i < movesCount; i++) {
+                char tag = board.turn;
+                pos action = {(unsigned short) (moves[i] % board.l), (unsigned short) (moves[i] / board.l)};
+                if (!board.performAction(tag, action)) {
+                    std::cout << "Corrupted episode log" << std::endl;
+                    exit(200);
+                }
+
+                if (tag == ai1.tag) ai1.addGameState(board.getStateKey());
+                else ai2.addGameState(board.getStateKey());
+            }
+
+            giveRewards(ai1, ai2, status);
+            games++;
+        }
+        printf("Replayed: %ldk\n", games / 1000);
+    }
+    delete[] moves;
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Training finished.\n";
+    printf("Replayed %ld games in %.1fs (%.0f games/s)\n", games, seconds, games / seconds);
+    saveAgents(ai1, ai2, fileName);
+}
+
+/**
+ * Reward the two agents for the game that just ended and
+ * prepare them for a new one
+ * @param ai1 The X agent
+ * @param ai2 The O agent
+ * @param status The final status of the game
+ */
+void BoardManager::giveRewards(Agent &ai1, Agent &ai2, int status) {
+    if (status >= 1 && status <= 3) {
+        ai1.feedReward(reward(ai1.tag, status));
+        ai2.feedReward(reward(ai2.tag, status));
+    } else printf("An error occurred\n");
+
+    ai1.newGame();
+    ai2.newGame();
+}
+
 /**
  * Play an AI vs Human game
  * @param aiFile The name of the ai file
  * @param debugMode If true, more info will be shown
+ * @param ponder If true, the AI works out its replies while
+ * the human is choosing a move
  */
-void BoardManager::AiVsHuman(const std::string &aiFile, bool debugMode) {
+void BoardManager::AiVsHuman(const std::string &aiFile, bool debugMode, bool ponder) {
     makeBoard(aiFile);
     Agent ai = Agent(&board);
     ai.load(aiFile);
+    if (ai.isTwoSided()) {
+        char side;
+        std::cout << "AI side (X/O): ";
+        std::cin >> side;
+        ai.tag = side == Board::O || side == 'o' ? Board::O : Board::X;
+    }
+    Ponderer ponderer(&ai, board.l, board.winStr);
 
     int status;
     char opt;
@@ -91,6 +444,7 @@ void BoardManager::AiVsHuman(const std::string &aiFile, bool debugMode) {
     do {
         board.reset();
         ai.newGame();
+        int humanCell = -1;
 
         do {
             printf("\n");
@@ -98,12 +452,17 @@ void BoardManager::AiVsHuman(const std::string &aiFile, bool debugMode) {
 
             do {
                 if (board.turn == ai.tag) {
-                    action = ai.chooseAction(true, debugMode);
+                    if (ponder && humanCell >= 0 && ponderer.reply(humanCell, action)) {
+                        if (debugMode) printf("[DEBUG] Pondered action (%d, %d)\n", action.x, action.y);
+                    } else action = ai.chooseAction(true, debugMode);
                 } else {
+                    if (ponder) ponderer.start(board);
                     printf("\n[%c] Choose coords (x y): ", board.turn);
                     std::cin >> action.x;
                     std::cin >> action.y;
                     fflush(stdin);
+                    if (ponder) ponderer.stop();
+                    humanCell = action.y * board.l + action.x;
                 }
             } while (!board.performAction(board.turn, action));
 
@@ -117,6 +476,8 @@ void BoardManager::AiVsHuman(const std::string &aiFile, bool debugMode) {
         else if (status == 3) printf("\n>>> Draw! <<<\n");
         else printf("\nAn error occurred\n");
 
+        if (ponder) printf("Replies from pondering: %ld of %ld\n", ponderer.hits, ponderer.hits + ponderer.misses);
+
         std::cout << "Play again? (y/n): ";
         std::cin >> opt;
     } while (opt == 'y');
@@ -136,6 +497,10 @@ void BoardManager::AiVsAi(const std::string &ai1File, const std::string &ai2File
     ai1.load(ai1File);
     ai2.load(ai2File);
 
+    // Two-sided AIs take the side left free by the other one
+    if (ai1.isTwoSided()) ai1.tag = ai2.isTwoSided() || ai2.tag == Board::O ? Board::X : Board::O;
+    if (ai2.isTwoSided()) ai2.tag = ai1.tag == Board::X ? Board::O : Board::X;
+
     if (ai1.tag == ai2.tag) {
         std::cout << "Incompatible AIs: same tags" << std::endl;
         exit(300);
@@ -173,32 +538,111 @@ void BoardManager::AiVsAi(const std::string &ai1File, const std::string &ai2File
     } while (opt == 'y');
 }
 
+/**
+ * Benchmark an AI file against a random player
+ * @param ai1File The name of the ai file
+ */
 void BoardManager::benchmarkAi(const std::string &ai1File) {
     makeBoard(ai1File);
 
     Agent ai1 = Agent(&board);
-    Agent ai2 = Agent(&board);
     ai1.load(ai1File);
-    ai2.setExplorationRate(1.0);
 
     printf("\nAI Info:\n");
     ai1.debug();
     printf("\n");
 
-    if (ai1.tag == Board::X) ai2.tag = Board::O;
-    else ai2.tag = Board::X;
+    // A two-sided AI is benchmarked on both sides
+    for (char tag: {Board::X, Board::O}) {
+        if (ai1.isTwoSided()) ai1.tag = tag;
+        else if (ai1.tag != tag) continue;
+
+        int xw, ow, draws;
+        playVsRandom(ai1, BENCH_ITERS, xw, ow, draws);
+
+        if (ai1.tag == Board::X) {
+            printf("AI      [X] win rate: %.3f%%\n", (float) xw/BENCH_ITERS*100.0);
+            printf("Checker [O] win rate: %.3f%%\n", (float) ow/BENCH_ITERS*100.0);
+            printf("\nYour AI lost %d times.\n", ow);
+        } else {
+            printf("AI      [O] win rate: %.3f%%\n", (float) ow/BENCH_ITERS*100.0);
+            printf("Checker [X] win rate: %.3f%%\n", (float) xw/BENCH_ITERS*100.0);
+            printf("\nYour AI lost %d times.\n", xw);
+        }
+        if (ai1.isTwoSided() && tag == Board::X) printf("\n");
+    }
+}
+
+/**
+ * Analyze an AI file and optionally save a compacted copy
+ * @param aiFile The name of the ai file
+ */
+void BoardManager::analyzeAi(const std::string &aiFile) {
+    makeBoard(aiFile);
+
+    Agent ai = Agent(&board);
+    ai.load(aiFile);
+
+    FILE *f = fopen(aiFile.c_str(), "r");
+    fseek(f, 0, SEEK_END);
+    long fileBytes = ftell(f);
+    fclose(f);
+
+    printf("\nAI Info:\n");
+    ai.debug();
+    printf("\n");
+
+    AgentAnalyzer analyzer = AgentAnalyzer(&ai, board.l, board.winStr);
+    analyzer.report(fileBytes);
+
+    char opt = 'n';
+    std::cout << "\nList the unreachable states? (y/n): ";
+    std::cin >> opt;
+    if (opt == 'y') analyzer.listUnreachable();
+
+    opt = 'n';
+    std::cout << "\nCompact the AI? (y/n): ";
+    std::cin >> opt;
+    if (opt != 'y') return;
+
+    float maxValue;
+    std::string fileName;
+    std::cout << "Maximum removable value: ";
+    bool valid = (bool) (std::cin >> maxValue);
+    std::cout << "Compacted file name: ";
+    fflush(stdin);
+    std::getline(std::cin, fileName);
+    if (!valid || fileName.empty()) {
+        std::cout << "Option not valid.\n";
+        return;
+    }
+
+    analyzer.compact(maxValue);
+    ai.save(fileName);
+}
+
+/**
+ * Play games between an agent, without exploration, and a
+ * player that chooses random actions
+ * @param ai The agent to evaluate
+ * @param games The number of games to play
+ * @param xw Number of games won by X
+ * @param ow Number of games won by O
+ * @param draws Number of games ended in a draw
+ * @return The number of games lost by the agent
+ */
+int BoardManager::playVsRandom(Agent &ai, int games, int &xw, int &ow, int &draws) {
+    Agent checker = Agent(&board, ai.tag == Board::X ? Board::O : Board::X, 1.0);
 
     int status;
     pos action;
-    int xw = 0, ow = 0, draws = 0;
-    for (int i = 0; i < BENCH_ITERS; i++) {
+    xw = 0, ow = 0, draws = 0;
+    for (int i = 0; i < games; i++) {
         board.reset();
-        ai1.newGame();
-        ai2.newGame();
 
         do {
-            if (board.turn == ai1.tag) action = ai1.chooseAction(true);
-            else action = ai2.chooseAction(false);
+            if (board.turn == ai.tag) action = ai.chooseAction(true);
+            else action = checker.chooseAction(false);
             board.performAction(board.turn, action);
 
             status = board.getGameStatus();
@@ -210,13 +654,19 @@ void BoardManager::benchmarkAi(const std::string &ai1File) {
         else printf("\nAn error occurred\n");
     }
 
-    if (ai1.tag == Board::X) printf("AI      [X] win rate: %.3f%%\n", (float) xw/BENCH_ITERS*100.0);
-    else printf("AI      [O] win rate: %.3f%%\n", (float) ow/BENCH_ITERS*100.0);
-    if (ai2.tag == Board::X) printf("Checker [X] win rate: %.3f%%\n", (float) xw/BENCH_ITERS*100.0);
-    else printf("Checker [O] win rate: %.3f%%\n", (float) ow/BENCH_ITERS*100.0);
+    board.reset();
+    return ai.tag == Board::X ? ow : xw;
+}
 
-    if (ai1.tag == Board::X) printf("\nYour AI lost %d times.\n", ow);
-    else printf("\nYour AI lost %d times.\n", xw);
+/**
+ * Play games between an agent and a random player
+ * @param ai The agent to evaluate
+ * @param games The number of games to play
+ * @return The number of games lost by the agent
+ */
+int BoardManager::playVsRandom(Agent &ai, int games) {
+    int xw, ow, draws;
+    return playVsRandom(ai, games, xw, ow, draws);
 }
 
 /**
@@ -225,7 +675,13 @@ void BoardManager::benchmarkAi(const std::string &ai1File) {
  * @param winStr Number of consecutive symbols needed to win
  */
 void BoardManager::makeBoard(int l, int winStr) {
+    if (l * l > Board::MAX_CELLS) {
+        printf("Boards bigger than %d cells are not supported\n", Board::MAX_CELLS);
+        exit(300);
+    }
+
     this->board = Board(l, winStr);
+    applySeed(board);
 
     this->board.reset();
 }
@@ -257,13 +713,28 @@ void BoardManager::makeBoard(const std::string &fileName) {
     fclose(f);
 
     if (currL == 0 && currWinStr == 0) {
+        if (newL * newL > Board::MAX_CELLS) {
+            printf("Boards bigger than %d cells are not supported\n", Board::MAX_CELLS);
+            exit(300);
+        }
         this->board = Board(newL, newWinStr);
+        applySeed(board);
     } else if (currL != newL || currWinStr != newWinStr) {
         std::cout << "Incompatible AIs: different board parameters" << std::endl;
         exit(300);
     }
 }
 
+/**
+ * Seed a board with one of the streams of the manager seed,
+ * if a seed was set
+ * @param b The board to seed
+ * @param stream The index of the stream (one per thread or game)
+ */
+void BoardManager::applySeed(Board &b, uint64_t stream) {
+    if (seeded) b.seed(seed, stream);
+}
+
 /**
  * Pauses the execution
  * @param seconds Number of seconds to wait
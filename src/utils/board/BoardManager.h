@@ -1,29 +1,67 @@
 #ifndef TICTACTOEAI_BOARDMANAGER_H
 #define TICTACTOEAI_BOARDMANAGER_H
 
+#include <functional>
 #include "Board.h"
 #include "../ai/Agent.h"
 
+#define REWARD_WIN 1.0f
+#define REWARD_LOSS (-0.5f)
+#define REWARD_DRAW 0.3f
+
+typedef struct {
+    float win;
+    float loss;
+    float draw;
+} rewards;
+
 class BoardManager {
 private:
+    bool seeded = false;
+    uint64_t seed = 0;
+    uint64_t nextStream = 1;
+
     static void delay(int);
 
+    void applySeed(Board &, uint64_t = 0);
+
+    float reward(char, int) const;
+
+    void giveRewards(Agent &, Agent &, int);
+
 public:
     Board board = Board(0, 0);
+    rewards gameRewards = {REWARD_WIN, REWARD_LOSS, REWARD_DRAW};
 
     BoardManager();
 
+    void setSeed(uint64_t);
+
+    int selfPlay(Agent &, Agent &, int, int, const std::function<bool(int, const int *, int, int)> &);
+
+    int playVsRandom(Agent &, int, int &, int &, int &);
+
+    int playVsRandom(Agent &, int);
+
+    static void saveAgents(Agent &, Agent &, const std::string &);
+
     void makeBoard(const std::string &);
 
-    void AiVsHuman(const std::string &, bool);
+    void AiVsHuman(const std::string &, bool, bool = false);
 
     void AiVsAi(const std::string &, const std::string &);
 
     void makeBoard(int, int);
 
-    void train(int, int, int);
+    void train(int, int, int, bool = false, int = 1, bool = false, int = 0, int = 0, float = -1.0f);
+
+    void replayTrain(const std::string &, float, float, bool = false, float = -1.0f);
+
+    void populationTrain(int, int, int, int, int);
 
     void benchmarkAi(const std::string&);
+
+    void analyzeAi(const std::string &);
 };
 
 
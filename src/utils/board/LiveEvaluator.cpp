@@ -0,0 +1,86 @@
+#include "LiveEvaluator.h"
+
+/**
+ * Evaluates snapshots of two training agents against a random
+ * player on a background thread, while the training goes on
+ * @param l The size of the board
+ * @param winStr The number of consecutive symbols needed to win
+ * @param games The number of games per agent of an evaluation
+ * @param seeded If true, the evaluation games are reproducible
+ * @param seed The seed of the evaluation games
+ */
+LiveEvaluator::LiveEvaluator(int l, int winStr, int games, bool seeded, uint64_t seed) {
+    if (seeded) bm.setSeed(seed);
+    bm.makeBoard(l, winStr);
+
+    this->games = games;
+    this->game = 0;
+    this->busy = false;
+    this->stopping = false;
+    this->worker = std::thread(&LiveEvaluator::run, this);
+}
+
+LiveEvaluator::~LiveEvaluator() {
+    finish();
+}
+
+/**
+ * Take a snapshot of two agents to evaluate it. It must be
+ * called by the thread that trains the agents, between two
+ * games, and it never waits for the evaluation.
+ * @param x The X agent
+ * @param o The O agent
+ * @param playedGames The number of games played by the agents
+ * @return false if the previous snapshot is still being evaluated
+ * and this one was skipped
+ */
+bool LiveEvaluator::submit(const Agent &x, const Agent &o, int playedGames) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (busy || stopping) return false;
+
+    ai1.reset(new Agent(x.snapshot(&bm.board)));
+    ai2.reset(new Agent(o.snapshot(&bm.board)));
+    if (o.isTwoSided()) ai2->shareValues(*ai1);
+    game = playedGames;
+    busy = true;
+    wake.notify_one();
+    return true;
+}
+
+/**
+ * Wait for the last snapshot to be evaluated and stop the thread
+ */
+void LiveEvaluator::finish() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+        wake.notify_one();
+    }
+    if (worker.joinable()) worker.join();
+}
+
+/**
+ * Body of the background thread
+ */
+void LiveEvaluator::run() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        wake.wait(lock, [this] { return busy || stopping; });
+        if (!busy) return;
+
+        lock.unlock();
+        int xw, ow, draws;
+        float lossX = (float) bm.playVsRandom(*ai1, games, xw, ow, draws) / games;
+        float drawsX = (float) draws / games;
+        float lossO = (float) bm.playVsRandom(*ai2, games, xw, ow, draws) / games;
+        float drawsO = (float) draws / games;
+        printf("[live %dk] X loss: %.2f%% (draws %.2f%%), O loss: %.2f%% (draws %.2f%%)\n", game / 1000,
+               lossX * 100.0f, drawsX * 100.0f, lossO * 100.0f, drawsO * 100.0f);
+        lock.lock();
+
+        // Release the snapshot, so that training stops cloning its chunks
+        ai1.reset();
+        ai2.reset();
+        busy = false;
+    }
+}
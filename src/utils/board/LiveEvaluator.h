@@ -0,0 +1,36 @@
+#ifndef TICTACTOEAI_LIVEEVALUATOR_H
+#define TICTACTOEAI_LIVEEVALUATOR_H
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "BoardManager.h"
+
+class LiveEvaluator {
+private:
+    BoardManager bm;
+    int games;
+    std::unique_ptr<Agent> ai1;
+    std::unique_ptr<Agent> ai2;
+    int game;
+    bool busy;
+    bool stopping;
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::thread worker;
+
+    void run();
+
+public:
+    LiveEvaluator(int, int, int, bool, uint64_t);
+
+    ~LiveEvaluator();
+
+    bool submit(const Agent &, const Agent &, int);
+
+    void finish();
+};
+
+
+#endif //TICTACTOEAI_LIVEEVALUATOR_H
@@ -0,0 +1,173 @@
+#include <iostream>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include "PopulationTrainer.h"
+
+#define PBT_EVAL_GAMES 2000         // games per side of a member evaluation
+#define PBT_EXPLOIT_FRACTION 4      // 1/n of the population is replaced each round
+#define PBT_PERTURB_DOWN 0.8f
+#define PBT_PERTURB_UP 1.2f
+
+// Ranges of the hyperparameters, the win reward is fixed to 1.0 as scale
+#define PBT_EXP_RATE_RANGE 0.01f, 0.6f
+#define PBT_DECAY_GAMMA_RANGE 0.5f, 0.999f
+#define PBT_LEARNING_RATE_RANGE 0.01f, 0.8f
+#define PBT_LOSS_RANGE (-1.0f), 0.0f
+#define PBT_DRAW_RANGE 0.0f, 0.9f
+
+/**
+ * Population based training: many agent pairs with different
+ * hyperparameters train in parallel, and periodically the
+ * worst pairs are replaced by perturbed copies of the best ones
+ * @param l The size of the board
+ * @param winStr The number of consecutive symbols needed to win
+ * @param populationSize The number of agent pairs
+ * @param seeded If true, the run is reproducible
+ * @param seed The seed from which every member seed is derived
+ */
+PopulationTrainer::PopulationTrainer(int l, int winStr, int populationSize, bool seeded, uint64_t seed) {
+    this->l = l;
+    this->winStr = winStr;
+    this->rng.seed(seeded ? seed : Rng::randomSeed());
+
+    for (int m = 0; m < populationSize; m++) {
+        std::unique_ptr<Member> member(new Member());
+        if (seeded) member->bm.setSeed(Rng(seed, m + 1)());
+        member->bm.makeBoard(l, winStr);
+
+        float expRate = randomIn(PBT_EXP_RATE_RANGE);
+        float decayGamma = randomIn(PBT_DECAY_GAMMA_RANGE);
+        float learningRate = randomIn(PBT_LEARNING_RATE_RANGE);
+        member->ai1.reset(new Agent(&member->bm.board, Board::X, expRate, decayGamma, learningRate));
+        member->ai2.reset(new Agent(&member->bm.board, Board::O, expRate, decayGamma, learningRate));
+        member->bm.gameRewards = {REWARD_WIN, randomIn(PBT_LOSS_RANGE), randomIn(PBT_DRAW_RANGE)};
+        member->score = 0.0f;
+        member->source = -1;
+
+        members.push_back(std::move(member));
+    }
+}
+
+/**
+ * Train the population and save the best agents
+ * @param rounds The number of train, evaluate and replace rounds
+ * @param gamesPerRound The number of games played by each member per round
+ * @param fileName The name of the best agents files, the hyperparameters
+ * history is saved in fileName.history
+ */
+void PopulationTrainer::run(int rounds, int gamesPerRound, const std::string &fileName) {
+    FILE *history = fopen((fileName + ".history").c_str(), "w");
+    if (history == nullptr) {
+        std::cout << "Cannot create the history file" << std::endl;
+        exit(200);
+    }
+    fprintf(history, "round member score expRate decayGamma learningRate win loss draw source\n");
+
+    const int n = (int) members.size();
+    std::vector<int> order(n);
+    for (int round = 1; round <= rounds; round++) {
+        forEachMember([&](Member &m) {
+            m.bm.selfPlay(*m.ai1, *m.ai2, gamesPerRound, 1, [](int, const int *, int, int) { return true; });
+
+            int losses = m.bm.playVsRandom(*m.ai1, PBT_EVAL_GAMES) + m.bm.playVsRandom(*m.ai2, PBT_EVAL_GAMES);
+            m.score = (float) losses / (2 * PBT_EVAL_GAMES);
+        });
+
+        for (int i = 0; i < n; i++) {
+            const Member &m = *members[i];
+            fprintf(history, "%d %d %.5f %.4f %.4f %.4f %.4f %.4f %.4f %d\n", round, i, m.score,
+                    m.ai1->getExplorationRate(), m.ai1->getDecayGamma(), m.ai1->getLearningRate(),
+                    m.bm.gameRewards.win, m.bm.gameRewards.loss, m.bm.gameRewards.draw, m.source);
+            order[i] = i;
+        }
+        fflush(history);
+
+        std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+            return members[a]->score < members[b]->score;
+        });
+        printf("Round %d/%d: best loss rate %.3f%% (member %d), worst %.3f%% (member %d)\n", round, rounds,
+               members[order[0]]->score * 100.0f, order[0], members[order[n - 1]]->score * 100.0f, order[n - 1]);
+
+        for (int i = 0; i < n; i++) members[i]->source = -1;
+        if (round == rounds || n < 2) continue;
+
+        int replaced = std::max(1, n / PBT_EXPLOIT_FRACTION);
+        for (int i = 0; i < replaced; i++) {
+            Member &worst = *members[order[n - 1 - i]];
+            exploit(worst, *members[order[i]]);
+            explore(worst);
+            worst.source = order[i];
+        }
+    }
+    fclose(history);
+
+    Member &best = *members[order[0]];
+    printf("\nBest member: %d, expRate %.4f, decayGamma %.4f, learningRate %.4f, rewards %.2f/%.2f/%.2f\n",
+           order[0], best.ai1->getExplorationRate(), best.ai1->getDecayGamma(), best.ai1->getLearningRate(),
+           best.bm.gameRewards.win, best.bm.gameRewards.loss, best.bm.gameRewards.draw);
+    BoardManager::saveAgents(*best.ai1, *best.ai2, fileName);
+}
+
+/**
+ * Run a task for every member, on as many threads as cores
+ * @param task The task
+ */
+void PopulationTrainer::forEachMember(const std::function<void(Member &)> &task) {
+    std::atomic<size_t> next(0);
+    unsigned threadsCount = std::max(1u, std::min((unsigned) members.size(), std::thread::hardware_concurrency()));
+
+    std::vector<std::thread> threads;
+    for (unsigned t = 0; t < threadsCount; t++) {
+        threads.emplace_back([&]() {
+            for (size_t i = next++; i < members.size(); i = next++) task(*members[i]);
+        });
+    }
+    for (std::thread &thread: threads) thread.join();
+}
+
+/**
+ * Overwrite a member with the weights and hyperparameters of another
+ * @param dst The replaced member
+ * @param src The copied member
+ */
+void PopulationTrainer::exploit(Member &dst, const Member &src) {
+    dst.ai1->values() = src.ai1->values();
+    dst.ai2->values() = src.ai2->values();
+    dst.ai1->setExplorationRate(src.ai1->getExplorationRate());
+    dst.ai1->setLearningParams(src.ai1->getDecayGamma(), src.ai1->getLearningRate());
+    dst.ai2->setExplorationRate(src.ai2->getExplorationRate());
+    dst.ai2->setLearningParams(src.ai2->getDecayGamma(), src.ai2->getLearningRate());
+    dst.bm.gameRewards = src.bm.gameRewards;
+}
+
+/**
+ * Perturb the hyperparameters of a member
+ * @param m The member
+ */
+void PopulationTrainer::explore(Member &m) {
+    auto perturb = [&](float value, float min, float max) {
+        value *= rng.nextInt(2) == 0 ? PBT_PERTURB_DOWN : PBT_PERTURB_UP;
+        return std::min(std::max(value, min), max);
+    };
+
+    float expRate = perturb(m.ai1->getExplorationRate(), PBT_EXP_RATE_RANGE);
+    float decayGamma = perturb(m.ai1->getDecayGamma(), PBT_DECAY_GAMMA_RANGE);
+    float learningRate = perturb(m.ai1->getLearningRate(), PBT_LEARNING_RATE_RANGE);
+    m.ai1->setExplorationRate(expRate);
+    m.ai2->setExplorationRate(expRate);
+    m.ai1->setLearningParams(decayGamma, learningRate);
+    m.ai2->setLearningParams(decayGamma, learningRate);
+    m.bm.gameRewards.loss = perturb(m.bm.gameRewards.loss, PBT_LOSS_RANGE);
+    m.bm.gameRewards.draw = perturb(m.bm.gameRewards.draw, PBT_DRAW_RANGE);
+}
+
+/**
+ * Random float in a range
+ * @param min The minimum value
+ * @param max The maximum value, excluded
+ * @return the random float
+ */
+float PopulationTrainer::randomIn(float min, float max) {
+    return min + (max - min) * rng.nextFloat();
+}
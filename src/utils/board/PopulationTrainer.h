@@ -0,0 +1,37 @@
+#ifndef TICTACTOEAI_POPULATIONTRAINER_H
+#define TICTACTOEAI_POPULATIONTRAINER_H
+
+#include <memory>
+#include "BoardManager.h"
+
+class PopulationTrainer {
+private:
+    struct Member {
+        BoardManager bm;
+        std::unique_ptr<Agent> ai1;
+        std::unique_ptr<Agent> ai2;
+        float score;
+        int source;
+    };
+
+    int l;
+    int winStr;
+    Rng rng;
+    std::vector<std::unique_ptr<Member>> members;
+
+    float randomIn(float, float);
+
+    void forEachMember(const std::function<void(Member &)> &);
+
+    void exploit(Member &, const Member &);
+
+    void explore(Member &);
+
+public:
+    PopulationTrainer(int, int, int, bool, uint64_t);
+
+    void run(int, int, const std::string &);
+};
+
+
+#endif //TICTACTOEAI_POPULATIONTRAINER_H
@@ -0,0 +1,247 @@
+#include <iostream>
+#include <cstring>
+#include "EpisodeLog.h"
+#include "../board/Board.h"
+
+static const char EPISODE_MAGIC[4] = {'T', 'T', 'T', 'E'};
+static const uint8_t EPISODE_VERSION = 1;
+
+/**
+ * Number of bits needed to store values from 0 to max
+ * @param max the biggest value
+ * @return the number of bits
+ */
+static int bitsFor(int max) {
+    int bits = 1;
+    while ((1 << bits) <= max) bits++;
+    return bits;
+}
+
+/**
+ * A streaming binary log of self-play games. Each game is
+ * stored as its moves count, its moves as cell indices and
+ * its final status, packed in as few bits as possible and
+ * written in blocks of about EPISODE_BLOCK_BYTES bytes.
+ * @param fileName name of the log file
+ * @param l Size of the board
+ * @param winStr Consecutive symbols needed to win
+ */
+EpisodeWriter::EpisodeWriter(const std::string &fileName, int l, int winStr) {
+    f = fopen(fileName.c_str(), "wb");
+    if (f == nullptr) {
+        std::cout << "Cannot create the episode log" << std::endl;
+        exit(200);
+    }
+
+    int cellsCount = l * l;
+    this->countBits = bitsFor(cellsCount);
+    this->moveBits = bitsFor(cellsCount - 1);
+    this->blockGames = 0;
+    this->bitBuffer = 0;
+    this->bitCount = 0;
+    this->gamesCount = 0;
+    this->block.reserve(EPISODE_BLOCK_BYTES + 64);
+
+    uint8_t header[4] = {EPISODE_VERSION, (uint8_t) l, (uint8_t) winStr, 0};
+    write(EPISODE_MAGIC, 1, sizeof(EPISODE_MAGIC));
+    write(header, 1, sizeof(header));
+}
+
+/**
+ * Store a game
+ * @param moves the moves of the game as cell indices, y * l + x
+ * @param movesCount number of moves
+ * @param status the final status of the game, as returned
+ * by Board::getGameStatus
+ */
+void EpisodeWriter::writeGame(const int *moves, int movesCount, int status) {
+    putBits(movesCount, countBits);
+    for (int i = 0; i < movesCount; i++) putBits(moves[i], moveBits);
+    putBits(status, 2);
+
+    blockGames++;
+    gamesCount++;
+
+    if (block.size() >= EPISODE_BLOCK_BYTES) flushBlock();
+}
+
+/**
+ * Append bits to the current block
+ * @param value the bits to append
+ * @param bits number of bits of value
+ */
+void EpisodeWriter::putBits(uint32_t value, int bits) {
+    bitBuffer |= (uint64_t) value << bitCount;
+    bitCount += bits;
+    while (bitCount >= 8) {
+        block.push_back((uint8_t) bitBuffer);
+        bitBuffer >>= 8;
+        bitCount -= 8;
+    }
+}
+
+/**
+ * Write the current block to the file
+ */
+void EpisodeWriter::flushBlock() {
+    if (bitCount > 0) {
+        block.push_back((uint8_t) bitBuffer);
+        bitBuffer = 0;
+        bitCount = 0;
+    }
+    if (blockGames == 0) return;
+
+    uint32_t blockHeader[2] = {blockGames, (uint32_t) block.size()};
+    write(blockHeader, sizeof(uint32_t), 2);
+    write(block.data(), 1, block.size());
+
+    block.clear();
+    blockGames = 0;
+}
+
+/**
+ * Write to the file, stopping if it cannot be written
+ * (e.g. the disk is full) instead of leaving a truncated log
+ * @param data the items to write
+ * @param size size of an item
+ * @param count number of items
+ */
+void EpisodeWriter::write(const void *data, size_t size, size_t count) {
+    if (fwrite(data, size, count, f) != count) {
+        std::cout << "Cannot write the episode log" << std::endl;
+        exit(200);
+    }
+}
+
+/**
+ * Write the pending games and close the file
+ */
+void EpisodeWriter::close() {
+    if (f == nullptr) return;
+
+    flushBlock();
+    int closed = fclose(f);
+    f = nullptr;
+    if (closed != 0) {
+        std::cout << "Cannot write the episode log" << std::endl;
+        exit(200);
+    }
+}
+
+EpisodeWriter::~EpisodeWriter() {
+    close();
+}
+
+/**
+ * Sequential reader of the logs written by EpisodeWriter
+ * @param fileName name of the log file
+ */
+EpisodeReader::EpisodeReader(const std::string &fileName) {
+    f = fopen(fileName.c_str(), "rb");
+    if (f == nullptr) {
+        std::cout << "The file does not exist" << std::endl;
+        exit(200);
+    }
+
+    char magic[4];
+    uint8_t header[4];
+    if (fread(magic, 1, sizeof(magic), f) != sizeof(magic) || memcmp(magic, EPISODE_MAGIC, sizeof(magic)) != 0 ||
+        fread(header, 1, sizeof(header), f) != sizeof(header) || header[0] != EPISODE_VERSION) {
+        std::cout << "Not a valid episode log" << std::endl;
+        exit(200);
+    }
+
+    this->l = header[1];
+    this->winStr = header[2];
+    if (l == 0 || l * l > Board::MAX_CELLS || winStr == 0 || winStr > l) {
+        std::cout << "Not a valid episode log" << std::endl;
+        exit(200);
+    }
+
+    this->cellsCount = l * l;
+    this->countBits = bitsFor(cellsCount);
+    this->moveBits = bitsFor(cellsCount - 1);
+    this->blockGames = 0;
+    this->bytePos = 0;
+    this->bitBuffer = 0;
+    this->bitCount = 0;
+}
+
+/**
+ * Load the next block of games
+ * @return false if there are no more blocks
+ */
+bool EpisodeReader::nextBlock() {
+    uint32_t blockHeader[2];
+    if (fread(blockHeader, sizeof(uint32_t), 2, f) != 2) return false;
+
+    // A game takes at least its moves count and status bits
+    if (blockHeader[1] > EPISODE_BLOCK_BYTES + 64 ||
+        (uint64_t) blockHeader[1] * 8 < (uint64_t) blockHeader[0] * (countBits + 2))
+        corrupted();
+
+    block.resize(blockHeader[1]);
+    if (fread(block.data(), 1, block.size(), f) != block.size()) {
+        std::cout << "Truncated episode log" << std::endl;
+        exit(200);
+    }
+
+    blockGames = blockHeader[0];
+    bytePos = 0;
+    bitBuffer = 0;
+    bitCount = 0;
+    return true;
+}
+
+/**
+ * Read the next game of the current block
+ * @param moves array of size l^2 where the moves will be put
+ * @param movesCount number of moves of the game
+ * @param status final status of the game
+ * @return false if the current block has no more games
+ */
+bool EpisodeReader::nextGame(int *moves, int &movesCount, int &status) {
+    if (blockGames == 0) return false;
+
+    movesCount = (int) getBits(countBits);
+    if (movesCount > cellsCount) corrupted();
+    for (int i = 0; i < movesCount; i++) {
+        moves[i] = (int) getBits(moveBits);
+        if (moves[i] >= cellsCount) corrupted();
+    }
+    status = (int) getBits(2);
+    if (status < 1 || status > 3) corrupted();
+
+    blockGames--;
+    return true;
+}
+
+/**
+ * Stop on a log whose games cannot have been written by train
+ */
+void EpisodeReader::corrupted() {
+    std::cout << "Corrupted episode log" << std::endl;
+    exit(200);
+}
+
+/**
+ * Extract bits from the current block
+ * @param bits number of bits to extract
+ * @return the extracted bits
+ */
+uint32_t EpisodeReader::getBits(int bits) {
+    while (bitCount < bits) {
+        uint64_t byte = bytePos < block.size() ? block[bytePos++] : 0;
+        bitBuffer |= byte << bitCount;
+        bitCount += 8;
+    }
+
+    auto value = (uint32_t) (bitBuffer & (((uint64_t) 1 << bits) - 1));
+    bitBuffer >>= bits;
+    bitCount -= bits;
+    return value;
+}
+
+EpisodeReader::~EpisodeReader() {
+    fclose(f);
+}
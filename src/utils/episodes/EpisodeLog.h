@@ -0,0 +1,69 @@
+#ifndef TICTACTOEAI_EPISODELOG_H
+#define TICTACTOEAI_EPISODELOG_H
+
+#include <cstdio>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#define EPISODE_BLOCK_BYTES (1 << 20)
+
+class EpisodeWriter {
+private:
+    FILE *f;
+    int countBits;
+    int moveBits;
+    std::vector<uint8_t> block;
+    uint32_t blockGames;
+    uint64_t bitBuffer;
+    int bitCount;
+
+    void putBits(uint32_t, int);
+
+    void flushBlock();
+
+    void write(const void *, size_t, size_t);
+
+public:
+    long gamesCount;
+
+    EpisodeWriter(const std::string &, int, int);
+
+    ~EpisodeWriter();
+
+    void writeGame(const int *, int, int);
+
+    void close();
+};
+
+class EpisodeReader {
+private:
+    FILE *f;
+    int countBits;
+    int moveBits;
+    std::vector<uint8_t> block;
+    uint32_t blockGames;
+    size_t bytePos;
+    uint64_t bitBuffer;
+    int bitCount;
+
+    uint32_t getBits(int);
+
+    static void corrupted();
+
+public:
+    int l;
+    int winStr;
+    int cellsCount;
+
+    explicit EpisodeReader(const std::string &);
+
+    ~EpisodeReader();
+
+    bool nextBlock();
+
+    bool nextGame(int *, int &, int &);
+};
+
+
+#endif //TICTACTOEAI_EPISODELOG_H
@@ -0,0 +1,123 @@
+#include <random>
+#include "Rng.h"
+
+/**
+ * A small and fast xoshiro256++ random generator with
+ * independent streams.
+ * @param seed The seed of the generator
+ * @param stream The index of the stream derived from the seed
+ */
+Rng::Rng(uint64_t seed, uint64_t stream) {
+    this->seed(seed, stream);
+}
+
+/**
+ * Reseed the generator. Every stream of the same seed is
+ * 2^128 numbers apart from the next one, so streams never
+ * overlap in practice.
+ * @param seed The seed of the generator
+ * @param stream The index of the stream derived from the seed
+ */
+void Rng::seed(uint64_t seed, uint64_t stream) {
+    uint64_t sm = seed;
+    for (int i = 0; i < 4; i++) s[i] = splitMix64(sm);
+
+    for (uint64_t i = 0; i < stream; i++) jump();
+}
+
+/**
+ * Advance the generator by 2^128 steps.
+ */
+void Rng::jump() {
+    static const uint64_t JUMP[] = {0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL,
+                                    0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL};
+
+    uint64_t t[4] = {0, 0, 0, 0};
+    for (uint64_t j: JUMP) {
+        for (int b = 0; b < 64; b++) {
+            if (j & (uint64_t) 1 << b) {
+                for (int i = 0; i < 4; i++) t[i] ^= s[i];
+            }
+            (*this)();
+        }
+    }
+
+    for (int i = 0; i < 4; i++) s[i] = t[i];
+}
+
+/**
+ * Generate the next 64 random bits.
+ * @return random 64 bits number
+ */
+Rng::result_type Rng::operator()() {
+    const uint64_t x = s[0] + s[3];
+    const uint64_t result = ((x << 23) | (x >> 41)) + s[0];
+    const uint64_t t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = (s[3] << 45) | (s[3] >> 19);
+
+    return result;
+}
+
+/**
+ * Generate random float between 0.0 and 1.0 excluded.
+ * @return random float between 0.0 and 1.0 excluded
+ */
+float Rng::nextFloat() {
+    return (float) ((*this)() >> 40) * (1.0f / 16777216.0f);
+}
+
+/**
+ * Generate random int between 0 and bound excluded, without
+ * modulo bias (Lemire's multiply and reject method).
+ * @param bound maximum number, must be greater than 0
+ * @return random int between 0 and bound excluded
+ */
+uint32_t Rng::nextInt(uint32_t bound) {
+    uint64_t m = ((*this)() >> 32) * bound;
+    auto low = (uint32_t) m;
+    if (low < bound) {
+        uint32_t threshold = -bound % bound;
+        while (low < threshold) {
+            m = ((*this)() >> 32) * bound;
+            low = (uint32_t) m;
+        }
+    }
+
+    return (uint32_t) (m >> 32);
+}
+
+/**
+ * Fill an array with random floats between 0.0 and 1.0 excluded.
+ * @param out array where the numbers will be put
+ * @param count size of the array
+ */
+void Rng::fillFloats(float *out, int count) {
+    for (int i = 0; i < count; i++) out[i] = nextFloat();
+}
+
+/**
+ * Get a non reproducible seed from the system.
+ * @return random seed
+ */
+uint64_t Rng::randomSeed() {
+    std::random_device rndDevice;
+    return ((uint64_t) rndDevice() << 32) ^ rndDevice();
+}
+
+/**
+ * SplitMix64 step, used to expand a seed into the full state.
+ * @param x state of the SplitMix64 generator
+ * @return next SplitMix64 output
+ */
+uint64_t Rng::splitMix64(uint64_t &x) {
+    uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
@@ -0,0 +1,37 @@
+#ifndef TICTACTOEAI_RNG_H
+#define TICTACTOEAI_RNG_H
+
+#include <cstdint>
+
+class Rng {
+private:
+    uint64_t s[4];
+
+    static uint64_t splitMix64(uint64_t &);
+
+public:
+    typedef uint64_t result_type;
+
+    explicit Rng(uint64_t = 0, uint64_t = 0);
+
+    void seed(uint64_t, uint64_t = 0);
+
+    void jump();
+
+    result_type operator()();
+
+    float nextFloat();
+
+    uint32_t nextInt(uint32_t);
+
+    void fillFloats(float *, int);
+
+    static uint64_t randomSeed();
+
+    static constexpr result_type min() { return 0; }
+
+    static constexpr result_type max() { return UINT64_MAX; }
+};
+
+
+#endif //TICTACTOEAI_RNG_H